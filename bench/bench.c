@@ -0,0 +1,775 @@
+/* Headless benchmark runner.
+ *
+ * Links the libretro core directly with a minimal frontend, loads a ROM,
+ * replays an input script for a fixed number of frames and reports the
+ * emulation speed together with per-frame hashes of the video and audio
+ * output. The hashes only depend on the emulated output, so they can be
+ * compared between commits and between machines to check that a change
+ * did not alter the emulation. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include <libretro.h>
+
+#ifdef MULTI_INSTANCE
+	#include "context.h"
+#endif
+
+#define BENCH_MAX_PORTS    5
+#define BENCH_MAX_OPTIONS  32
+#define BENCH_MAX_COUNTERS 64
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME  0x100000001b3ULL
+
+typedef struct
+{
+	uint32_t frame;
+	uint32_t line;  /* In the script, so that events on the same frame keep their order */
+	uint8_t  type;
+	uint8_t  port;
+	uint32_t value;
+} BenchEvent;
+
+enum
+{
+	EVENT_PAD,
+	EVENT_AV,
+	EVENT_RESET
+};
+
+typedef struct
+{
+	const char* key;
+	const char* value;
+} BenchOption;
+
+static const struct
+{
+	const char* name;
+	uint32_t    id;
+} button_names[] =
+{
+	{"b",      RETRO_DEVICE_ID_JOYPAD_B},
+	{"y",      RETRO_DEVICE_ID_JOYPAD_Y},
+	{"select", RETRO_DEVICE_ID_JOYPAD_SELECT},
+	{"start",  RETRO_DEVICE_ID_JOYPAD_START},
+	{"up",     RETRO_DEVICE_ID_JOYPAD_UP},
+	{"down",   RETRO_DEVICE_ID_JOYPAD_DOWN},
+	{"left",   RETRO_DEVICE_ID_JOYPAD_LEFT},
+	{"right",  RETRO_DEVICE_ID_JOYPAD_RIGHT},
+	{"a",      RETRO_DEVICE_ID_JOYPAD_A},
+	{"x",      RETRO_DEVICE_ID_JOYPAD_X},
+	{"l",      RETRO_DEVICE_ID_JOYPAD_L},
+	{"r",      RETRO_DEVICE_ID_JOYPAD_R},
+	{"l2",     RETRO_DEVICE_ID_JOYPAD_L2}
+};
+
+static BenchEvent* events     = NULL;
+static size_t      num_events = 0;
+static size_t      next_event = 0;
+
+static BenchOption options[BENCH_MAX_OPTIONS];
+static size_t      num_options = 0;
+
+static struct retro_core_option_v2_definition* option_defs = NULL;
+
+/* Counters registered by the core when it is built with PERF_TEST=1,
+ * along with their values at the end of the warm-up frames */
+static struct retro_perf_counter* counters[BENCH_MAX_COUNTERS];
+static retro_perf_tick_t          counter_calls[BENCH_MAX_COUNTERS];
+static retro_perf_tick_t          counter_ticks[BENCH_MAX_COUNTERS];
+static size_t                     num_counters = 0;
+
+static uint32_t pad_state[BENCH_MAX_PORTS];
+static int      av_state    = 3;
+static bool     video_shown = false;
+static bool     quiet       = false;
+static int      state_ctx   = RETRO_SAVESTATE_CONTEXT_NORMAL;
+
+static uint64_t video_hash      = FNV_OFFSET;
+static uint64_t audio_hash      = FNV_OFFSET;
+static uint64_t last_video_hash = 0;
+static uint32_t dupe_frames     = 0;
+
+static INLINE uint64_t fnv_byte(uint64_t hash, uint8_t byte)
+{
+	return (hash ^ byte) * FNV_PRIME;
+}
+
+/* Values are hashed in little endian order so that the results do not
+ * depend on the host byte order. */
+static INLINE uint64_t fnv_word(uint64_t hash, uint16_t word)
+{
+	return fnv_byte(fnv_byte(hash, (uint8_t) word), (uint8_t) (word >> 8));
+}
+
+static uint64_t time_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static retro_time_t perf_get_time_usec()
+{
+	return (retro_time_t) (time_ns() / 1000);
+}
+
+static retro_perf_tick_t perf_get_counter()
+{
+	return time_ns();
+}
+
+static uint64_t perf_get_cpu_features()
+{
+	uint64_t cpu = 0;
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("mmx"))
+		cpu |= RETRO_SIMD_MMX;
+
+	if (__builtin_cpu_supports("sse"))
+		cpu |= RETRO_SIMD_SSE;
+
+	if (__builtin_cpu_supports("sse2"))
+		cpu |= RETRO_SIMD_SSE2;
+
+	if (__builtin_cpu_supports("sse3"))
+		cpu |= RETRO_SIMD_SSE3;
+
+	if (__builtin_cpu_supports("ssse3"))
+		cpu |= RETRO_SIMD_SSSE3;
+
+	if (__builtin_cpu_supports("sse4.1"))
+		cpu |= RETRO_SIMD_SSE4;
+
+	if (__builtin_cpu_supports("sse4.2"))
+		cpu |= RETRO_SIMD_SSE42;
+
+	if (__builtin_cpu_supports("avx"))
+		cpu |= RETRO_SIMD_AVX;
+
+	if (__builtin_cpu_supports("avx2"))
+		cpu |= RETRO_SIMD_AVX2;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	cpu |= RETRO_SIMD_NEON;
+#endif
+
+	return cpu;
+}
+
+static void perf_register(struct retro_perf_counter* counter)
+{
+	if (num_counters < BENCH_MAX_COUNTERS)
+		counters[num_counters++] = counter;
+
+	counter->registered = true;
+}
+
+static void perf_start(struct retro_perf_counter* counter)
+{
+	counter->call_cnt++;
+	counter->start = time_ns();
+}
+
+static void perf_stop(struct retro_perf_counter* counter)
+{
+	counter->total += time_ns() - counter->start;
+}
+
+static void perf_log()
+{
+	/* The counters are reported together with the other results */
+}
+
+static void snapshot_counters()
+{
+	size_t i;
+
+	for (i = 0; i < num_counters; i++)
+	{
+		counter_calls[i] = counters[i]->call_cnt;
+		counter_ticks[i] = counters[i]->total;
+	}
+}
+
+static void bench_log(enum retro_log_level level, const char* fmt, ...)
+{
+	va_list ap;
+
+	if (quiet && level < RETRO_LOG_WARN)
+		return;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+}
+
+static const char* get_option(const char* key)
+{
+	size_t i;
+
+	for (i = 0; i < num_options; i++)
+		if (!strcmp(options[i].key, key))
+			return options[i].value;
+
+	/* Fall back to the default value declared by the core */
+	for (i = 0; option_defs && option_defs[i].key; i++)
+		if (!strcmp(option_defs[i].key, key))
+			return option_defs[i].default_value;
+
+	return NULL;
+}
+
+static bool environment(unsigned cmd, void* data)
+{
+	switch (cmd)
+	{
+		case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+			((struct retro_log_callback*) data)->log = bench_log;
+			return true;
+		case RETRO_ENVIRONMENT_GET_CORE_OPTIONS_VERSION:
+			*(unsigned*) data = 2;
+			return true;
+		case RETRO_ENVIRONMENT_SET_CORE_OPTIONS_V2:
+			option_defs = ((struct retro_core_options_v2*) data)->definitions;
+			return true;
+		case RETRO_ENVIRONMENT_SET_CORE_OPTIONS_V2_INTL:
+			option_defs = ((struct retro_core_options_v2_intl*) data)->us->definitions;
+			return true;
+		case RETRO_ENVIRONMENT_GET_VARIABLE:
+		{
+			struct retro_variable* var = (struct retro_variable*) data;
+			var->value = get_option(var->key);
+			return var->value != NULL;
+		}
+		case RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE:
+			*(bool*) data = false;
+			return true;
+		case RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE:
+			*(int*) data = av_state;
+			return true;
+		case RETRO_ENVIRONMENT_GET_INPUT_BITMASKS:
+		case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+		case RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS:
+		case RETRO_ENVIRONMENT_SET_SUPPORT_ACHIEVEMENTS:
+			return true;
+		case RETRO_ENVIRONMENT_GET_PERF_INTERFACE:
+		{
+			struct retro_perf_callback* perf = (struct retro_perf_callback*) data;
+			perf->get_time_usec    = perf_get_time_usec;
+			perf->get_cpu_features = perf_get_cpu_features;
+			perf->get_perf_counter = perf_get_counter;
+			perf->perf_register    = perf_register;
+			perf->perf_start       = perf_start;
+			perf->perf_stop        = perf_stop;
+			perf->perf_log         = perf_log;
+			return true;
+		}
+		case RETRO_ENVIRONMENT_GET_SAVESTATE_CONTEXT:
+			*(int*) data = state_ctx;
+			return true;
+		case RETRO_ENVIRONMENT_GET_CAN_DUPE:
+			*(bool*) data = true;
+			return true;
+		case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+			*(const char**) data = ".";
+			return true;
+		case RETRO_ENVIRONMENT_SET_MESSAGE:
+			bench_log(RETRO_LOG_INFO, "%s\n", ((const struct retro_message*) data)->msg);
+			return true;
+		default:
+			/* Frameskip, audio buffer status and the like are disabled
+			 * by refusing the request, keeping every run deterministic. */
+			return false;
+	}
+}
+
+static void video_refresh(const void* data, unsigned width, unsigned height, size_t pitch)
+{
+	unsigned x, y;
+	uint64_t hash = FNV_OFFSET;
+
+	video_shown = true;
+
+	if (!(av_state & 1))
+	{
+		last_video_hash = 0;
+		return;
+	}
+
+	if (!data) /* Duped frame: identical to the previous one */
+	{
+		dupe_frames++;
+		video_hash = fnv_byte(video_hash, 1);
+		return;
+	}
+
+	for (y = 0; y < height; y++)
+	{
+		const uint16_t* line = (const uint16_t*) ((const uint8_t*) data + y * pitch);
+
+		for (x = 0; x < width; x++)
+			hash = fnv_word(hash, line[x]);
+	}
+
+	hash = fnv_word(fnv_word(hash, (uint16_t) width), (uint16_t) height);
+	last_video_hash = hash;
+	video_hash = fnv_byte(video_hash, 0);
+	video_hash = (video_hash ^ hash) * FNV_PRIME;
+}
+
+static size_t audio_sample_batch(const int16_t* data, size_t frames)
+{
+	size_t i;
+
+	for (i = 0; i < frames * 2; i++)
+		audio_hash = fnv_word(audio_hash, (uint16_t) data[i]);
+
+	return frames;
+}
+
+static void audio_sample(int16_t left, int16_t right)
+{
+	audio_hash = fnv_word(fnv_word(audio_hash, (uint16_t) left), (uint16_t) right);
+}
+
+static void input_poll()
+{
+}
+
+static int16_t input_state(unsigned port, unsigned device, unsigned index, unsigned id)
+{
+	(void) index;
+
+	if (port >= BENCH_MAX_PORTS || device != RETRO_DEVICE_JOYPAD)
+		return 0;
+
+	if (id == RETRO_DEVICE_ID_JOYPAD_MASK)
+		return (int16_t) pad_state[port];
+
+	return (pad_state[port] >> id) & 1;
+}
+
+static bool parse_buttons(const char* str, uint32_t* mask)
+{
+	char buf[128];
+	char* tok;
+	size_t i;
+	*mask = 0;
+
+	if (!strcmp(str, "none"))
+		return true;
+
+	strncpy(buf, str, sizeof(buf) - 1);
+	buf[sizeof(buf) - 1] = '\0';
+
+	for (tok = strtok(buf, "+"); tok; tok = strtok(NULL, "+"))
+	{
+		for (i = 0; i < sizeof(button_names) / sizeof(button_names[0]); i++)
+		{
+			if (!strcmp(tok, button_names[i].name))
+			{
+				*mask |= 1 << button_names[i].id;
+				break;
+			}
+		}
+
+		if (i == sizeof(button_names) / sizeof(button_names[0]))
+			return false;
+	}
+
+	return true;
+}
+
+static int compare_events(const void* a, const void* b)
+{
+	const BenchEvent* ea = (const BenchEvent*) a;
+	const BenchEvent* eb = (const BenchEvent*) b;
+
+	if (ea->frame != eb->frame)
+		return ea->frame < eb->frame ? -1 : 1;
+
+	return ea->line < eb->line ? -1 : 1;
+}
+
+/* Input scripts contain one event per line:
+ *     <frame> pad <port> <button+button...|none>
+ *     <frame> av <bits>      (RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE value)
+ *     <frame> reset
+ * Button states persist until they are changed. Lines starting with '#'
+ * are comments. */
+static bool load_script(const char* path)
+{
+	char line[256];
+	unsigned lineno = 0;
+	FILE* fp = fopen(path, "r");
+
+	if (!fp)
+	{
+		fprintf(stderr, "Cannot open input script %s\n", path);
+		return false;
+	}
+
+	while (fgets(line, sizeof(line), fp))
+	{
+		char cmd[16], arg1[128], arg2[128];
+		unsigned frame;
+		int n;
+		BenchEvent ev;
+		lineno++;
+
+		if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+			continue;
+
+		n = sscanf(line, "%u %15s %127s %127s", &frame, cmd, arg1, arg2);
+		memset(&ev, 0, sizeof(ev));
+		ev.frame = frame;
+		ev.line  = lineno;
+
+		if (n == 4 && !strcmp(cmd, "pad"))
+		{
+			ev.type = EVENT_PAD;
+			ev.port = (uint8_t) atoi(arg1);
+
+			if (ev.port >= BENCH_MAX_PORTS || !parse_buttons(arg2, &ev.value))
+				n = 0;
+		}
+		else if (n >= 3 && !strcmp(cmd, "av"))
+		{
+			ev.type = EVENT_AV;
+			ev.value = (uint32_t) strtoul(arg1, NULL, 0);
+		}
+		else if (n >= 2 && !strcmp(cmd, "reset"))
+			ev.type = EVENT_RESET;
+		else
+			n = 0;
+
+		if (n == 0)
+		{
+			fprintf(stderr, "%s:%u: invalid event\n", path, lineno);
+			fclose(fp);
+			return false;
+		}
+
+		events = (BenchEvent*) realloc(events, (num_events + 1) * sizeof(BenchEvent));
+		events[num_events++] = ev;
+	}
+
+	fclose(fp);
+	qsort(events, num_events, sizeof(BenchEvent), compare_events);
+	return true;
+}
+
+static void apply_events(uint32_t frame)
+{
+	for (; next_event < num_events && events[next_event].frame <= frame; next_event++)
+	{
+		const BenchEvent* ev = &events[next_event];
+
+		switch (ev->type)
+		{
+			case EVENT_PAD:
+				pad_state[ev->port] = ev->value;
+				break;
+			case EVENT_AV:
+				av_state = (int) ev->value;
+				break;
+			case EVENT_RESET:
+				retro_reset();
+				break;
+		}
+	}
+}
+
+/* Runs one frame the way a frontend does single-instance run-ahead: the real frame is run with its video hidden and
+ * saved, the following ones are run hidden and silent, the last of them is shown and the real frame is loaded back. */
+static void run_ahead(uint32_t ahead, uint8_t* state, size_t state_size)
+{
+	int av = av_state;
+	uint32_t i;
+
+	av_state = av & ~1;
+	retro_run();
+	retro_serialize(state, state_size);
+	av_state = av & ~3;
+
+	for (i = 1; i < ahead; i++)
+		retro_run();
+
+	av_state = av & ~2;
+	retro_run();
+	av_state = av;
+	retro_unserialize(state, state_size);
+}
+
+static uint8_t* load_file(const char* path, size_t* size)
+{
+	uint8_t* data;
+	long len;
+	FILE* fp = fopen(path, "rb");
+
+	if (!fp)
+		return NULL;
+
+	if (fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0)
+	{
+		fclose(fp);
+		return NULL;
+	}
+
+	data = (uint8_t*) malloc(len > 0 ? len : 1);
+
+	if (data && fread(data, 1, len, fp) != (size_t) len)
+	{
+		free(data);
+		data = NULL;
+	}
+
+	fclose(fp);
+	*size = (size_t) len;
+	return data;
+}
+
+static int compare_u64(const void* a, const void* b)
+{
+	uint64_t va = *(const uint64_t*) a;
+	uint64_t vb = *(const uint64_t*) b;
+	return va < vb ? -1 : va > vb;
+}
+
+static uint64_t percentile(const uint64_t* sorted, size_t count, unsigned pct)
+{
+	size_t idx;
+
+	if (count == 0)
+		return 0;
+
+	idx = (count * pct + 99) / 100;
+	return sorted[idx > 0 ? idx - 1 : 0];
+}
+
+static void usage(const char* name)
+{
+	fprintf(stderr,
+		"Usage: %s [options] <rom>\n"
+		"  -n <frames>      number of measured frames (default 3600)\n"
+		"  -w <frames>      warm-up frames excluded from timing (default 0)\n"
+		"  -i <script>      input script to replay\n"
+		"  -a <bits>        initial audio/video enable bits (default 3)\n"
+		"  -o <key=value>   set a core option (may be repeated)\n"
+		"  -H <file>        write per-frame video and audio hashes to <file>\n"
+		"  -r <frames>      run ahead by <frames>, reporting same-instance run-ahead states\n"
+		"  -R <frames>      run ahead by <frames>, reporting normal states\n"
+		"  -q               only print the summary\n",
+		name);
+}
+
+int main(int argc, char** argv)
+{
+	struct retro_game_info game;
+	struct retro_system_av_info av_info;
+	const char* rom_path    = NULL;
+	const char* script_path = NULL;
+	const char* hash_path   = NULL;
+	FILE* hash_fp           = NULL;
+	uint32_t frames         = 3600;
+	uint32_t warmup         = 0;
+	uint32_t ahead          = 0;
+	uint8_t* state          = NULL;
+	size_t state_size       = 0;
+	uint32_t frame;
+	uint64_t* frame_ns;
+	uint64_t total_ns       = 0;
+	uint8_t* rom;
+	size_t rom_size;
+	int i;
+#ifdef MULTI_INSTANCE
+	SContext* ctx;
+#endif
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-n") && i + 1 < argc)
+			frames = (uint32_t) strtoul(argv[++i], NULL, 0);
+		else if (!strcmp(argv[i], "-w") && i + 1 < argc)
+			warmup = (uint32_t) strtoul(argv[++i], NULL, 0);
+		else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+			script_path = argv[++i];
+		else if (!strcmp(argv[i], "-a") && i + 1 < argc)
+			av_state = (int) strtol(argv[++i], NULL, 0);
+		else if (!strcmp(argv[i], "-H") && i + 1 < argc)
+			hash_path = argv[++i];
+		else if ((!strcmp(argv[i], "-r") || !strcmp(argv[i], "-R")) && i + 1 < argc)
+		{
+			state_ctx = argv[i][1] == 'r' ? RETRO_SAVESTATE_CONTEXT_RUNAHEAD_SAME_INSTANCE : RETRO_SAVESTATE_CONTEXT_NORMAL;
+			ahead     = (uint32_t) strtoul(argv[++i], NULL, 0);
+		}
+		else if (!strcmp(argv[i], "-q"))
+			quiet = true;
+		else if (!strcmp(argv[i], "-o") && i + 1 < argc && num_options < BENCH_MAX_OPTIONS)
+		{
+			char* eq = strchr(argv[++i], '=');
+
+			if (!eq)
+			{
+				usage(argv[0]);
+				return 1;
+			}
+
+			*eq = '\0';
+			options[num_options].key = argv[i];
+			options[num_options].value = eq + 1;
+			num_options++;
+		}
+		else if (argv[i][0] != '-' && !rom_path)
+			rom_path = argv[i];
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!rom_path || frames == 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (script_path && !load_script(script_path))
+		return 1;
+
+	rom = load_file(rom_path, &rom_size);
+
+	if (!rom)
+	{
+		fprintf(stderr, "Cannot read ROM %s\n", rom_path);
+		return 1;
+	}
+
+	if (hash_path && !(hash_fp = fopen(hash_path, "w")))
+	{
+		fprintf(stderr, "Cannot write %s\n", hash_path);
+		return 1;
+	}
+
+#ifdef MULTI_INSTANCE
+	if (!(ctx = CreateContext()))
+	{
+		fprintf(stderr, "Cannot create a context\n");
+		return 1;
+	}
+
+	BindContext(ctx);
+#endif
+	retro_set_environment(environment);
+	retro_set_video_refresh(video_refresh);
+	retro_set_audio_sample(audio_sample);
+	retro_set_audio_sample_batch(audio_sample_batch);
+	retro_set_input_poll(input_poll);
+	retro_set_input_state(input_state);
+	retro_init();
+
+	game.path = rom_path;
+	game.data = rom;
+	game.size = rom_size;
+	game.meta = NULL;
+
+	if (!retro_load_game(&game))
+	{
+		fprintf(stderr, "Failed to load %s\n", rom_path);
+		return 1;
+	}
+
+	retro_get_system_av_info(&av_info);
+
+	if (ahead)
+	{
+		state_size = retro_serialize_size();
+		state      = (uint8_t*) malloc(state_size);
+	}
+
+	frame_ns = (uint64_t*) calloc(frames, sizeof(uint64_t));
+
+	for (frame = 0; frame < warmup + frames; frame++)
+	{
+		uint64_t start, elapsed;
+		uint64_t prev_audio = audio_hash;
+		apply_events(frame);
+
+		if (frame == warmup)
+			snapshot_counters();
+
+		video_shown = false;
+		start = time_ns();
+
+		if (ahead)
+			run_ahead(ahead, state, state_size);
+		else
+			retro_run();
+
+		elapsed = time_ns() - start;
+
+		if (frame >= warmup)
+		{
+			frame_ns[frame - warmup] = elapsed;
+			total_ns += elapsed;
+		}
+
+		if (!video_shown)
+			fprintf(stderr, "Frame %u: no video callback\n", frame);
+
+		if (hash_fp)
+			fprintf(hash_fp, "%u %016llx %016llx\n", frame, (unsigned long long) last_video_hash, (unsigned long long) (audio_hash ^ prev_audio));
+	}
+
+	qsort(frame_ns, frames, sizeof(uint64_t), compare_u64);
+	printf("rom:        %s\n", rom_path);
+	printf("frames:     %u (+%u warm-up) @ %.3f Hz\n", frames, warmup, av_info.timing.fps);
+	printf("fps:        %.2f (%.2fx realtime)\n", frames / (total_ns / 1e9), frames / (total_ns / 1e9) / av_info.timing.fps);
+	printf("ns/frame:   mean %llu  p50 %llu  p90 %llu  p99 %llu  max %llu\n",
+		(unsigned long long) (total_ns / frames),
+		(unsigned long long) percentile(frame_ns, frames, 50),
+		(unsigned long long) percentile(frame_ns, frames, 90),
+		(unsigned long long) percentile(frame_ns, frames, 99),
+		(unsigned long long) frame_ns[frames - 1]);
+	printf("dupes:      %u\n", dupe_frames);
+	printf("video hash: %016llx\n", (unsigned long long) video_hash);
+	printf("audio hash: %016llx\n", (unsigned long long) audio_hash);
+
+	if (num_counters)
+		printf("counters:   per frame\n");
+
+	for (i = 0; i < (int) num_counters; i++)
+	{
+		double calls = (double) (counters[i]->call_cnt - counter_calls[i]) / frames;
+		double ticks = (double) (counters[i]->total - counter_ticks[i]) / frames;
+
+		if (ticks > 0)
+			printf("  %-22s %14.1f calls %12.0f ns\n", counters[i]->ident, calls, ticks);
+		else
+			printf("  %-22s %14.1f\n", counters[i]->ident, calls);
+	}
+
+	if (hash_fp)
+		fclose(hash_fp);
+
+	retro_unload_game();
+	retro_deinit();
+#ifdef MULTI_INSTANCE
+	DestroyContext(ctx);
+#endif
+	free(frame_ns);
+	free(state);
+	free(events);
+	free(rom);
+	return 0;
+}
@@ -15,39 +15,69 @@
 #include "cheats.h"
 #include "display.h"
 #include "gfx.h"
+#include "gfxthread.h"
+#include "rewind.h"
 #include "cpuexec.h"
 #include "spc7110.h"
 #include "srtc.h"
 #include "sa1.h"
+#include "sdd1.h"
 #include "libretro_core_options.h"
 
 #define FRAME_TIME         (Settings.PAL ? 20000        : 16667)
 #define FRAMES_PER_SECOND  (Settings.PAL ? 50.006977968 : 60.09881389744051)
 
-static retro_log_printf_t         log_cb         = NULL;
-static retro_video_refresh_t      video_cb       = NULL;
-static retro_input_poll_t         poll_cb        = NULL;
-static retro_input_state_t        input_cb       = NULL;
-static retro_audio_sample_batch_t audio_batch_cb = NULL;
-static retro_environment_t        environ_cb     = NULL;
+#ifdef MULTI_INSTANCE
+	#define log_cb                              (*log_cbPtr)
+	#define video_cb                            (*video_cbPtr)
+	#define poll_cb                             (*poll_cbPtr)
+	#define input_cb                            (*input_cbPtr)
+	#define audio_batch_cb                      (*audio_batch_cbPtr)
+	#define environ_cb                          (*environ_cbPtr)
+	#define libretro_supports_option_categories (*libretro_supports_option_categoriesPtr)
+	#define libretro_supports_bitmasks          (*libretro_supports_bitmasksPtr)
+	#define audio_out_buffer                    (*audio_out_bufferPtr)
+	#define audio_samples_per_frame             (*audio_samples_per_framePtr)
+	#define audio_samples_accumulator           (*audio_samples_accumulatorPtr)
+	#define frameskip_type                      (*frameskip_typePtr)
+	#define frameskip_threshold                 (*frameskip_thresholdPtr)
+	#define retro_audio_buff_active             (*retro_audio_buff_activePtr)
+	#define retro_audio_buff_occupancy          (*retro_audio_buff_occupancyPtr)
+	#define retro_audio_buff_underrun           (*retro_audio_buff_underrunPtr)
+	#define retro_audio_latency                 (*retro_audio_latencyPtr)
+	#define update_audio_latency                (*update_audio_latencyPtr)
+	#define mute_audio                          (*mute_audioPtr)
+	#define rewind_seconds                      (*rewind_secondsPtr)
+	#define rewind_state                        (*rewind_statePtr)
+#endif
+
+STATIC_INSTANCE retro_log_printf_t         log_cb;
+STATIC_INSTANCE retro_video_refresh_t      video_cb;
+STATIC_INSTANCE retro_input_poll_t         poll_cb;
+STATIC_INSTANCE retro_input_state_t        input_cb;
+STATIC_INSTANCE retro_audio_sample_batch_t audio_batch_cb;
+STATIC_INSTANCE retro_environment_t        environ_cb;
 
-static bool libretro_supports_option_categories = false;
-static bool libretro_supports_bitmasks = false;
+STATIC_INSTANCE bool libretro_supports_option_categories;
+STATIC_INSTANCE bool libretro_supports_bitmasks;
 
-static int16_t* audio_out_buffer           = NULL;
-static float    audio_samples_per_frame    = 0.0f;
-static float    audio_samples_accumulator  = 0.0f;
+STATIC_INSTANCE int16_t* audio_out_buffer;
+STATIC_INSTANCE float    audio_samples_per_frame;
+STATIC_INSTANCE float    audio_samples_accumulator;
 
-static uint8_t  frameskip_type             = 0;
-static uint8_t  frameskip_threshold        = 0;
+STATIC_INSTANCE uint8_t  frameskip_type;
+STATIC_INSTANCE uint8_t  frameskip_threshold;
 
-static bool     retro_audio_buff_active    = false;
-static uint8_t  retro_audio_buff_occupancy = 0;
-static bool     retro_audio_buff_underrun  = false;
+STATIC_INSTANCE bool     retro_audio_buff_active;
+STATIC_INSTANCE uint8_t  retro_audio_buff_occupancy;
+STATIC_INSTANCE bool     retro_audio_buff_underrun;
 
-static unsigned retro_audio_latency        = 0;
-static bool     update_audio_latency       = false;
-static bool     mute_audio                 = false;
+STATIC_INSTANCE unsigned retro_audio_latency;
+STATIC_INSTANCE bool     update_audio_latency;
+STATIC_INSTANCE bool     mute_audio;
+
+STATIC_INSTANCE uint32_t rewind_seconds;
+STATIC_INSTANCE uint8_t* rewind_state;
 
 void retro_set_environment(retro_environment_t cb)
 {
@@ -99,6 +129,39 @@ unsigned retro_api_version()
 	return RETRO_API_VERSION;
 }
 
+#ifdef PERF_TEST
+static void perf_dummy(struct retro_perf_counter* counter)
+{
+}
+
+static void perf_init()
+{
+	int32_t i;
+
+	for (i = 0; i < PERF_COUNTERS; i++)
+	{
+		PerfCounters[i].start      = 0;
+		PerfCounters[i].total      = 0;
+		PerfCounters[i].call_cnt   = 0;
+		PerfCounters[i].registered = false;
+	}
+
+	if (!environ_cb(RETRO_ENVIRONMENT_GET_PERF_INTERFACE, &PerfCallback) || !PerfCallback.perf_register)
+	{
+		if (log_cb)
+			log_cb(RETRO_LOG_WARN, "Frontend has no performance interface - counters are not reported.\n");
+
+		memset(&PerfCallback, 0, sizeof(PerfCallback));
+		PerfCallback.perf_start = perf_dummy;
+		PerfCallback.perf_stop  = perf_dummy;
+		return;
+	}
+
+	for (i = 0; i < PERF_COUNTERS; i++)
+		PerfCallback.perf_register(&PerfCounters[i]);
+}
+#endif
+
 static void retro_audio_buff_status_cb(bool active, unsigned occupancy, bool underrun_likely)
 {
 	retro_audio_buff_active    = active;
@@ -239,6 +302,39 @@ static void audio_upload_samples()
 		audio_batch_cb(audio_out_buffer, available_frames);
 }
 
+static void rewind_deinit()
+{
+	DeinitRewind();
+	free(rewind_state);
+	rewind_state = NULL;
+}
+
+/* Saves the state at the start of every frame, or goes back to the last one saved while the rewind button is held */
+static bool unserialize(const void* data, size_t size, bool same_instance);
+
+static void rewind_run()
+{
+	size_t size = retro_serialize_size();
+
+	if (!Rewind && (!(rewind_state = (uint8_t*) malloc(size)) || !InitRewind(size, (uint32_t) (rewind_seconds * FRAMES_PER_SECOND))))
+	{
+		if (log_cb)
+			log_cb(RETRO_LOG_WARN, "Not enough memory to rewind %u seconds.\n", rewind_seconds);
+
+		rewind_deinit();
+		rewind_seconds = 0;
+		return;
+	}
+
+	if (input_cb(0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L2))
+	{
+		if (PopRewindState(rewind_state))
+			unserialize(rewind_state, size, true);
+	}
+	else if (retro_serialize(rewind_state, size))
+		PushRewindState(rewind_state);
+}
+
 void retro_init()
 {
 	struct retro_log_callback log;
@@ -263,6 +359,9 @@ void retro_init()
 	InitDisplay();
 	InitGFX();
 	ResetSound(true);
+#ifdef PERF_TEST
+	perf_init();
+#endif
 
 	if (environ_cb(RETRO_ENVIRONMENT_GET_INPUT_BITMASKS, NULL))
 		libretro_supports_bitmasks = true;
@@ -273,11 +372,18 @@ void retro_deinit()
 	if ((Settings.Chip & SPC7110) == SPC7110)
 		DeinitSPC7110();
 
+	DeinitSDD1();
 	DeinitGFX();
 	DeinitDisplay();
 	DeinitAPU();
 	DeinitMemory();
 	audio_out_buffer_deinit();
+	rewind_deinit();
+
+#ifdef PERF_TEST
+	if (PerfCallback.perf_log)
+		PerfCallback.perf_log();
+#endif
 
 	/* Reset globals (required for static builds) */
 	libretro_supports_option_categories = false;
@@ -290,6 +396,7 @@ void retro_deinit()
 	retro_audio_latency                 = 0;
 	update_audio_latency                = false;
 	mute_audio                          = false;
+	rewind_seconds                      = 0;
 }
 
 uint32_t ReadJoypad(int32_t port)
@@ -336,6 +443,11 @@ static void check_variables(bool first_run)
 	char* endptr;
 	double freq = 10.0;
 	int32_t overclock_type = 0;
+	uint32_t prev_rewind_seconds;
+	bool prev_sa1_slices;
+#ifdef THREADED_RENDER
+	uint8_t render_threads;
+#endif
 
 	static const int8_t overclock_cycles[4][2] = {{6, 8}, {6, 6}, {3, 4}, {1, 1}};
 
@@ -402,6 +514,14 @@ static void check_variables(bool first_run)
 	/* Convert MHz value to Hz and multiply by required factors. */
 	Settings.SuperFXSpeedPerLine = (uint32_t) ((582340.5 * freq) * ((1.0f / FRAMES_PER_SECOND) / ((float) SNES_MAX_VCOUNTER)));
 
+	var.key = "chimerasnes_superfx_slices";
+	var.value = NULL;
+	Settings.SuperFXSlices = false;
+
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+		if (strcmp(var.value, "enabled") == 0)
+			Settings.SuperFXSlices = true;
+
 	var.key = "chimerasnes_reduce_sprite_flicker";
 	var.value = NULL;
 	Settings.ReduceSpriteFlicker = false;
@@ -410,6 +530,64 @@ static void check_variables(bool first_run)
 		if (strcmp(var.value, "enabled") == 0)
 			Settings.ReduceSpriteFlicker = true;
 
+	var.key = "chimerasnes_skip_unchanged_frames";
+	var.value = NULL;
+	Settings.SkipUnchangedFrames = false;
+
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value && strcmp(var.value, "enabled") == 0)
+	{
+		bool can_dupe = false;
+
+		/* The frontend has to be able to show the last frame again */
+		if (environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &can_dupe) && can_dupe)
+			Settings.SkipUnchangedFrames = true;
+	}
+
+	/* Options such as the sprite limit change what is drawn from the same PPU state */
+	ScreenSnapshot.Valid = false;
+
+	var.key = "chimerasnes_sa1_slices";
+	var.value = NULL;
+	prev_sa1_slices = Settings.SA1Slices;
+	Settings.SA1Slices = false;
+
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+		if (strcmp(var.value, "enabled") == 0)
+			Settings.SA1Slices = true;
+
+	/* The SA-1 is never behind between frames, so the main loop can be swapped right away */
+	if (Settings.SA1Slices != prev_sa1_slices)
+		SetMainLoop();
+
+	var.key = "chimerasnes_rewind";
+	var.value = NULL;
+	prev_rewind_seconds = rewind_seconds;
+	rewind_seconds      = 0;
+
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+		rewind_seconds = strtol(var.value, NULL, 10);
+
+	/* The history is allocated again on the next frame */
+	if (rewind_seconds != prev_rewind_seconds)
+		rewind_deinit();
+
+#ifdef THREADED_RENDER
+	var.key = "chimerasnes_render_threads";
+	var.value = NULL;
+	render_threads = 1;
+
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+		render_threads = (uint8_t) strtol(var.value, NULL, 10);
+
+	/* The render threads are idle between frames, so they can be replaced right away */
+	if (render_threads != Settings.RenderThreads)
+	{
+		Settings.RenderThreads = render_threads;
+		DeinitRenderThread();
+		InitRenderThread();
+	}
+#endif
+
 	/* Reinitialise frameskipping, if required */
 	if (!first_run && (frameskip_type != prev_frameskip_type))
 		retro_set_audio_buff_status_cb();
@@ -419,7 +597,8 @@ void retro_run()
 {
 	int result;
 	bool okay;
-	bool updated = false;
+	bool video_enabled = true;
+	bool updated       = false;
 
 	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE, &updated) && updated)
 		check_variables(false);
@@ -434,10 +613,10 @@ void retro_run()
 
 	if (okay)
 	{
-		bool videoEnabled     = (bool) (result & 1);
 		bool audioEnabled     = (bool) (result & 2);
 		bool hardDisableAudio = (bool) (result & 8);
-		IPPU.RenderThisFrame  = videoEnabled;
+		video_enabled         = (bool) (result & 1);
+		IPPU.RenderThisFrame  = video_enabled;
 		mute_audio            = !audioEnabled;
 		Settings.APUEnabled   = !hardDisableAudio;
 	}
@@ -481,15 +660,30 @@ void retro_run()
 		update_audio_latency = false;
 	}
 
+	/* A frame runs from the start of V-blank to the end of the next picture, so the auto-joypad read comes two
+	 * scanlines after this and the picture sent below already shows what the game did with the input. Polling any
+	 * later would gain nothing. */
 	poll_cb();
+
+	/* The frames run-ahead hides are loaded over again, so only the ones that are shown go into the history */
+	if (rewind_seconds && video_enabled)
+		rewind_run();
+
+	PERF_START(PERF_MAIN_LOOP);
 	MainLoop();
+	PERF_STOP(PERF_MAIN_LOOP);
 	audio_upload_samples();
 
 #ifdef NO_VIDEO_OUTPUT
 	return;
 #endif
 
-	if (IPPU.RenderThisFrame)
+#ifdef THREADED_RENDER
+	/* A PPU write in the lines of the next frame run before the main loop returned can still be drawing */
+	WaitRenderThread();
+#endif
+
+	if (IPPU.RenderThisFrame && !IPPU.SkipScreen)
 	{
 	#ifdef PSP
 		static uint32_t __attribute__((aligned(16))) d_list[32];
@@ -622,16 +816,45 @@ bool retro_serialize(void* data, size_t size)
 	return true;
 }
 
-bool retro_unserialize(const void* data, size_t size)
+/* Only the 16 byte rows of VRAM that differ are copied, so only the tiles in those have to be converted again */
+static void unserialize_vram(const uint8_t* vram)
+{
+	uint32_t row;
+
+	for (row = 0; row < MAX_2BIT_TILES; row++)
+	{
+		if (!memcmp(Memory.VRAM + (row << 4), vram + (row << 4), 16))
+			continue;
+
+		memcpy(Memory.VRAM + (row << 4), vram + (row << 4), 16);
+		IPPU.TileCached[TILE_2BIT][row]      = false;
+		IPPU.TileCached[TILE_4BIT][row >> 1] = false;
+		IPPU.TileCached[TILE_8BIT][row >> 2] = false;
+	}
+}
+
+/* States saved by this same instance, such as the ones run-ahead and rewinding go back to, are loaded without resetting
+ * the console first. Everything the state holds is simply overwritten, while the tile caches, the colour tables and the
+ * instruction runs predecoded from the ROM are kept where they are still valid. The result is the same either way. */
+static bool unserialize(const void* data, size_t size, bool same_instance)
 {
 	const uint8_t* buffer = data;
 	uint8_t* IAPU_RAM_current = IAPU.RAM;
 	uintptr_t IAPU_RAM_offset;
+	bool colours_changed = true;
 
 	if (size != retro_serialize_size())
 		return false;
 
-	Reset();
+	if (same_instance)
+	{
+		const uint8_t* ppu = buffer + sizeof(CPU) + sizeof(ICPU);
+		colours_changed = ppu[offsetof(SPPU, Brightness)] != PPU.Brightness || memcmp(ppu + offsetof(SPPU, CGDATA), PPU.CGDATA, sizeof(PPU.CGDATA));
+		ResetForStateLoad();
+	}
+	else
+		Reset();
+
 	memcpy(&CPU, buffer, sizeof(CPU));
 	buffer += sizeof(CPU);
 	memcpy(&ICPU, buffer, sizeof(ICPU));
@@ -640,7 +863,12 @@ bool retro_unserialize(const void* data, size_t size)
 	buffer += sizeof(PPU);
 	memcpy(&DMA, buffer, sizeof(DMA));
 	buffer += sizeof(DMA);
-	memcpy(Memory.VRAM, buffer, 0x10000);
+
+	if (same_instance)
+		unserialize_vram(buffer);
+	else
+		memcpy(Memory.VRAM, buffer, 0x10000);
+
 	buffer += 0x10000;
 	memcpy(Memory.RAM, buffer, 0x20000);
 	buffer += 0x20000;
@@ -671,11 +899,20 @@ bool retro_unserialize(const void* data, size_t size)
 	IPPU.ColorsChanged = true;
 	IPPU.OBJChanged = true;
 	CPU.InDMA = false;
-	FixColourBrightness();
+
+	if (colours_changed)
+	{
+		IPPU.DirectColourMapsNeedRebuild = true;
+		FixColourBrightness();
+	}
+
 	SRTCPostLoadState();
 	SA1UnpackStatus();
 	APUUnpackStatus();
-	RestoreAPUDSP();
+
+	if (!same_instance) /* FixSoundAfterSnapshotLoad does it again */
+		RestoreAPUDSP();
+
 	FixSoundAfterSnapshotLoad();
 	SetPlaybackRate(SNES_SAMPLE_RATE);
 	ICPU.ShiftedPB = ICPU.Registers.PB << 16;
@@ -687,6 +924,23 @@ bool retro_unserialize(const void* data, size_t size)
 	return true;
 }
 
+bool retro_unserialize(const void* data, size_t size)
+{
+	enum retro_savestate_context context = RETRO_SAVESTATE_CONTEXT_NORMAL;
+
+	if (!environ_cb(RETRO_ENVIRONMENT_GET_SAVESTATE_CONTEXT, &context))
+		context = RETRO_SAVESTATE_CONTEXT_NORMAL;
+
+	if (!unserialize(data, size, context == RETRO_SAVESTATE_CONTEXT_RUNAHEAD_SAME_INSTANCE))
+		return false;
+
+	/* Run-ahead goes back to the state the last frame shown was saved from, while any other state starts a new history */
+	if (Rewind && context != RETRO_SAVESTATE_CONTEXT_RUNAHEAD_SAME_INSTANCE)
+		ClearRewind();
+
+	return true;
+}
+
 void retro_cheat_reset()
 {
 	RemoveCheats();
@@ -725,6 +979,7 @@ static void init_descriptors()
 		describe_buttons(2),
 		describe_buttons(3),
 		describe_buttons(4),
+		{0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L2, "Rewind"},
 		{0, 0, 0, 0, NULL}
 	};
 
@@ -770,6 +1025,7 @@ bool retro_load_game_special(unsigned game_type, const struct retro_game_info* i
 
 void retro_unload_game()
 {
+	rewind_deinit();
 }
 
 void* retro_get_memory_data(unsigned type)
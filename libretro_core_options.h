@@ -154,6 +154,20 @@ struct retro_core_option_v2_definition option_defs_us[] =
 		},
 		"10 MHz (SNES clock, Default)"
 	},
+	{
+		"chimerasnes_superfx_slices",
+		"Run SuperFX in Slices (Unsafe)",
+		NULL,
+		"Lets the SuperFX chip fall up to 16 scanlines behind the SNES CPU, until the latter reads or writes the SuperFX registers or RAM, instead of running it at the end of every scanline. Speeds up SuperFX games, but interrupts from the SuperFX arrive later.",
+		NULL,
+		"hacks",
+		{
+			{ "disabled", NULL },
+			{ "enabled",  NULL },
+			{ NULL,       NULL },
+		},
+		"disabled"
+	},
 	{
 		"chimerasnes_reduce_sprite_flicker",
 		"Reduce Flickering (Unsafe)",
@@ -168,6 +182,74 @@ struct retro_core_option_v2_definition option_defs_us[] =
 		},
 		"disabled"
 	},
+	{
+		"chimerasnes_sa1_slices",
+		"Run SA-1 in Slices (Unsafe)",
+		NULL,
+		"Lets the SA-1 run ahead of the SNES CPU until the latter touches the SA-1 registers, writes to memory the two share or reaches the end of a scanline, instead of switching between them after every instruction. Speeds up SA-1 games, but interrupts from the SA-1 arrive later.",
+		NULL,
+		"hacks",
+		{
+			{ "disabled", NULL },
+			{ "enabled",  NULL },
+			{ NULL,       NULL },
+		},
+		"disabled"
+	},
+	{
+		"chimerasnes_rewind",
+		"Rewind (Seconds)",
+		NULL,
+		"Keeps the last seconds of play in memory so that they can be played backwards by holding L2 on the first controller. Only what changed from one frame to the next is kept, in a buffer of about 240 KB per second. Games that change a lot of memory every frame can be rewound for less time than this.",
+		NULL,
+		NULL,
+		{
+			{ "disabled", NULL },
+			{ "5",        NULL },
+			{ "10",       NULL },
+			{ "20",       NULL },
+			{ "30",       NULL },
+			{ "60",       NULL },
+			{ NULL,       NULL },
+		},
+		"disabled"
+	},
+	{
+		"chimerasnes_skip_unchanged_frames",
+		"Skip Unchanged Frames",
+		NULL,
+		"Neither draws nor sends frames that are the same as the last one, as in menus, dialogue and paused games, so that the frontend shows the last one again. Only takes effect if the frontend supports it.",
+		NULL,
+		NULL,
+		{
+			{ "disabled", NULL },
+			{ "enabled",  NULL },
+			{ NULL,       NULL },
+		},
+		"disabled"
+	},
+#ifdef THREADED_RENDER
+	{
+		"chimerasnes_render_threads",
+		"Render Threads",
+		NULL,
+		"Number of threads drawing the screen while the emulation runs ahead. With more than one, each thread draws its own bands of lines, which helps games that change the screen often on processors with cores to spare.",
+		NULL,
+		NULL,
+		{
+			{ "1", NULL },
+			{ "2", NULL },
+			{ "3", NULL },
+			{ "4", NULL },
+			{ "5", NULL },
+			{ "6", NULL },
+			{ "7", NULL },
+			{ "8", NULL },
+			{ NULL, NULL },
+		},
+		"1"
+	},
+#endif
 	{ NULL, NULL, NULL, NULL, NULL, NULL, {{0}}, NULL },
 };
 
@@ -4,6 +4,7 @@
 #include <retro_inline.h>
 
 #include "port.h"
+#include "perf.h"
 #include "spc700.h"
 
 enum
@@ -102,9 +103,16 @@ typedef struct
 	int32_t  Cycles;
 } SAPU;
 
-extern SAPU    APU;
-extern SIAPU   IAPU;
-extern uint8_t APUCycles[256];       /* Scaled cycle lengths */
+#ifdef MULTI_INSTANCE
+	#define APU       (*APUPtr)
+	#define IAPU      (*IAPUPtr)
+	#define APUCycles (*APUCyclesPtr)
+#endif
+
+extern INSTANCE SAPU    APU;
+extern INSTANCE SIAPU   IAPU;
+extern INSTANCE uint8_t APUCycles[256]; /* Scaled cycle lengths */
+
 extern uint8_t APUCycleLengths[256]; /* Raw data. */
 extern void  (*ApuOpcodes[256])();
 
@@ -145,6 +153,7 @@ static INLINE void APUExecute()
 	{
 		APU.Cycles += APUCycles[*IAPU.PC];
 		(*ApuOpcodes[*IAPU.PC])();
+		PERF_COUNT(PERF_APU_OPS, 1);
 	}
 }
 #endif
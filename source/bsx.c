@@ -12,9 +12,17 @@
 
 #define BSXPPUBASE 0x2180
 
-static uint32_t FlashSize;
-static uint8_t* MapROM;
-static uint8_t* FlashROM;
+#ifdef MULTI_INSTANCE
+	#define FlashSize (*FlashSizePtr)
+	#define MapROM    (*MapROMPtr)
+	#define FlashROM  (*FlashROMPtr)
+	#define RTCTime   (*RTCTimePtr)
+#endif
+
+STATIC_INSTANCE uint32_t FlashSize;
+STATIC_INSTANCE uint8_t* MapROM;
+STATIC_INSTANCE uint8_t* FlashROM;
+STATIC_INSTANCE time_t   RTCTime;
 
 static void BSX_Map_SNES();
 static void BSX_Map_LoROM();
@@ -440,6 +448,7 @@ static void BSX_Map()
 	BSX.dirty2 = false;
 
 	map_WriteProtectROM();
+	InvalidateCPUBlocks();
 }
 
 static uint8_t BSX_Get_Bypass_FlashIO(uint32_t offset)
@@ -462,6 +471,8 @@ static void BSX_Set_Bypass_FlashIO(uint32_t offset, uint8_t byte)
 		FlashROM[offset & 0x0FFFFF] = FlashROM[offset & 0x0FFFFF] & byte;
 	else
 		FlashROM[(offset & 0x1F0000) >> 1 | (offset & 0x7FFF)] = FlashROM[(offset & 0x1F0000) >> 1 | (offset & 0x7FFF)] & byte;
+
+	InvalidateCPUBlocks();
 }
 
 uint8_t GetBSX(uint32_t address)
@@ -612,11 +623,13 @@ void SetBSX(uint8_t byte, uint32_t address)
 							FlashROM[((address & 0x1E0000) >> 1) + x] = 0xFF;
 					}
 
+					InvalidateCPUBlocks();
 					break;
 				case 0xA7D0: /* Chip Erase */
 					for (x = 0; x < FLASH_SIZE; x++)
 						FlashROM[x] = 0xFF;
 
+					InvalidateCPUBlocks();
 					break;
 				case 0x38D0: /* Flashcart Reset */
 				default:
@@ -641,16 +654,15 @@ static void BSXSetStream(uint8_t count, stream_t* stream, uint32_t firstreg)
 	pathp += dirlen;
 	memcpy(pathp, SLASH_STR, slashlen);
 	pathp += slashlen;
-	pathp += snprintf(pathp, sizeof(path) - dirlen - slashlen, "BSX%04X-%d.bin", (BSX.PPU[firstreg - BSXPPUBASE] | (BSX.PPU[firstreg + 1 - BSXPPUBASE] * 256)), count); /* BSXHHHH-DDD.bin */
+	pathp += snprintf(pathp, sizeof(path) - dirlen - slashlen, "BSX%04X-%d.bin", (BSX.PPURegs[firstreg - BSXPPUBASE] | (BSX.PPURegs[firstreg + 1 - BSXPPUBASE] * 256)), count); /* BSXHHHH-DDD.bin */
 	stream_open(stream, path);
 
 	if (stream->file)
-		BSX.PPU[firstreg + 5 - BSXPPUBASE] = 0;
+		BSX.PPURegs[firstreg + 5 - BSXPPUBASE] = 0;
 }
 
 uint8_t BSXGetRTC() /* Get Time */
 {
-	static time_t t;
 	struct tm* tmr;
 	uint8_t index = BSX.out_index;
 	BSX.out_index++;
@@ -683,9 +695,9 @@ uint8_t BSXGetRTC() /* Get Time */
 	}
 
 	if (index == 10)
-		time(&t);
+		time(&RTCTime);
 
-	tmr = localtime(&t);
+	tmr = localtime(&RTCTime);
 
 	switch (index)
 	{
@@ -722,7 +734,7 @@ uint8_t GetBSXPPU(uint16_t address)
 			if (!s->pf_latch_enable || !s->dt_latch_enable)
 				return 0;
 
-			if (BSX.PPU[address - 2 - BSXPPUBASE] == 0 && BSX.PPU[address - 1 - BSXPPUBASE] == 0)
+			if (BSX.PPURegs[address - 2 - BSXPPUBASE] == 0 && BSX.PPURegs[address - 1 - BSXPPUBASE] == 0)
 				return 1;
 
 			if (s->queue <= 0)
@@ -740,11 +752,11 @@ uint8_t GetBSXPPU(uint16_t address)
 			if (s->file)
 			{
 				if (s->queue >= 128) /* Lock at 0x7F for bigger packets */
-					BSX.PPU[address - BSXPPUBASE] = 0x7F;
+					BSX.PPURegs[address - BSXPPUBASE] = 0x7F;
 				else
-					BSX.PPU[address - BSXPPUBASE] = s->queue;
+					BSX.PPURegs[address - BSXPPUBASE] = s->queue;
 
-				return BSX.PPU[address - BSXPPUBASE];
+				return BSX.PPURegs[address - BSXPPUBASE];
 			}
 
 			return 0;
@@ -753,8 +765,8 @@ uint8_t GetBSXPPU(uint16_t address)
 			if (!s->pf_latch_enable)
 				return 0;
 
-			if (BSX.PPU[address - 3 - BSXPPUBASE] == 0 && BSX.PPU[address - 2 - BSXPPUBASE] == 0)
-				BSX.PPU[address - BSXPPUBASE] = 0x90;
+			if (BSX.PPURegs[address - 3 - BSXPPUBASE] == 0 && BSX.PPURegs[address - 2 - BSXPPUBASE] == 0)
+				BSX.PPURegs[address - BSXPPUBASE] = 0x90;
 
 			if (s->file)
 			{
@@ -769,26 +781,26 @@ uint8_t GetBSXPPU(uint16_t address)
 				if (--s->queue == 0) /* Last packet */
 					t |= 0x80;
 
-				BSX.PPU[address - BSXPPUBASE] = t;
+				BSX.PPURegs[address - BSXPPUBASE] = t;
 			}
 
-			BSX.PPU[address + 2 - BSXPPUBASE] |= BSX.PPU[address - BSXPPUBASE];
-			return BSX.PPU[address - BSXPPUBASE];
+			BSX.PPURegs[address + 2 - BSXPPUBASE] |= BSX.PPURegs[address - BSXPPUBASE];
+			return BSX.PPURegs[address - BSXPPUBASE];
 		case 0x218C: /* Stream 1 - Data Latch (R/W) */
 		case 0x2192: /* Stream 2 */
 			if (!s->dt_latch_enable)
 				return 0;
 
-			if (BSX.PPU[address - 4 - BSXPPUBASE] == 0 && BSX.PPU[address - 3 - BSXPPUBASE] == 0)
-				BSX.PPU[address - BSXPPUBASE] = BSXGetRTC();
+			if (BSX.PPURegs[address - 4 - BSXPPUBASE] == 0 && BSX.PPURegs[address - 3 - BSXPPUBASE] == 0)
+				BSX.PPURegs[address - BSXPPUBASE] = BSXGetRTC();
 			else if (s->file)
-				BSX.PPU[address - BSXPPUBASE] = stream_get(s);
+				BSX.PPURegs[address - BSXPPUBASE] = stream_get(s);
 
-			return BSX.PPU[address - BSXPPUBASE];
+			return BSX.PPURegs[address - BSXPPUBASE];
 		case 0x218D: /* Stream 1 - OR gate (R) */
 		case 0x2193: /* Stream 2 */
-			t = BSX.PPU[address - BSXPPUBASE];
-			BSX.PPU[address - BSXPPUBASE] = 0;
+			t = BSX.PPURegs[address - BSXPPUBASE];
+			BSX.PPURegs[address - BSXPPUBASE] = 0;
 			return t;
 		case 0x2188: /* Stream 1 - Logical Channel 1 + Data Structure (R/W) */
 		case 0x218E: /* Stream 2 */
@@ -800,7 +812,7 @@ uint8_t GetBSXPPU(uint16_t address)
 		case 0x2197: /* Soundlink Settings (R/W) */
 		case 0x2198: /* Serial I/O - Serial Number (R/W) */
 		case 0x2199: /* Serial I/O - Unknown (R/W) */
-			return BSX.PPU[address - BSXPPUBASE];
+			return BSX.PPURegs[address - BSXPPUBASE];
 		default:
 			return ICPU.OpenBus;
 	}
@@ -818,10 +830,10 @@ void SetBSXPPU(uint8_t byte, uint16_t address)
 			/* fall through */
 		case 0x2188: /* Stream 1 - Logical Channel 1 + Data Structure (R/W) */
 		case 0x218E: /* Stream 2 */
-			if (BSX.PPU[address - BSXPPUBASE] == byte)
+			if (BSX.PPURegs[address - BSXPPUBASE] == byte)
 				s->count = 0;
 
-			BSX.PPU[address - BSXPPUBASE] = byte;
+			BSX.PPURegs[address - BSXPPUBASE] = byte;
 			break;
 		case 0x218B: /* Stream 1 - Prefix Latch (R/W) */
 		case 0x2191: /* Stream 2 */
@@ -829,7 +841,7 @@ void SetBSXPPU(uint8_t byte, uint16_t address)
 			break;
 		case 0x218C: /* Stream 1 - Data Latch (R/W) */
 		case 0x2192: /* Stream 2 */
-			if (BSX.PPU[address - 4 - BSXPPUBASE] == 0 && BSX.PPU[address - 3 - BSXPPUBASE] == 0)
+			if (BSX.PPURegs[address - 4 - BSXPPUBASE] == 0 && BSX.PPURegs[address - 3 - BSXPPUBASE] == 0)
 				BSX.out_index = 0;
 
 			s->dt_latch_enable = (bool) byte;
@@ -838,7 +850,7 @@ void SetBSXPPU(uint8_t byte, uint16_t address)
 			byte &= 0x0F;
 			/* fall through */
 		case 0x2197: /* Soundlink Settings (R/W) */
-			BSX.PPU[address - BSXPPUBASE] = byte;
+			BSX.PPURegs[address - BSXPPUBASE] = byte;
 			break;
 	}
 }
@@ -933,7 +945,7 @@ void ResetBSX()
 	if (Settings.Chip == BSFW)
 		memset(Memory.ROM, 0, FLASH_SIZE);
 
-	memset(BSX.PPU,     0, sizeof(BSX.PPU));
+	memset(BSX.PPURegs, 0, sizeof(BSX.PPURegs));
 	memset(BSX.MMC,     0, sizeof(BSX.MMC));
 	memset(BSX.prevMMC, 0, sizeof(BSX.prevMMC));
 	BSX.dirty         = false;
@@ -966,8 +978,8 @@ void ResetBSX()
 	}
 
 	/* default register values */
-	BSX.PPU[0x2196 - BSXPPUBASE] = 0x10;
-	BSX.PPU[0x2197 - BSXPPUBASE] = 0x80;
+	BSX.PPURegs[0x2196 - BSXPPUBASE] = 0x10;
+	BSX.PPURegs[0x2197 - BSXPPUBASE] = 0x80;
 
 	/* stream reset */
 	stream_close(&BSX.sat_stream1);
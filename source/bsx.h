@@ -27,7 +27,7 @@ typedef struct
 	uint8_t  out_index;
 	uint8_t  MMC[16];
 	uint8_t  prevMMC[16];
-	uint8_t  PPU[32];
+	uint8_t  PPURegs[32];
 	uint32_t flash_command; /* Flash command */
 	uint32_t old_write;     /* Previous flash write address */
 	uint32_t new_write;     /* Current flash write address */
@@ -35,7 +35,11 @@ typedef struct
 	stream_t sat_stream2;
 } SBSX;
 
-extern SBSX BSX;
+#ifdef MULTI_INSTANCE
+	#define BSX (*BSXPtr)
+#endif
+
+extern INSTANCE SBSX BSX;
 
 uint8_t  GetBSX(uint32_t address);
 void     SetBSX(uint8_t byte, uint32_t address);
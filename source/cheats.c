@@ -2,33 +2,20 @@
 
 #include "chisnes.h"
 #include "cheats.h"
+#include "cpuexec.h"
+#include "fxemu.h"
 #include "memmap.h"
+#include "sdd1.h"
+#include "spc7110dec.h"
 
-#define MAX_CHEATS 800
-
-typedef struct
-{
-	bool     saved        : 1;
-	int16_t  _SCheat_PAD1 : 15;
-	uint8_t  byte;
-	uint8_t  saved_byte;
-	uint32_t address;
-} SCheat;
-
-typedef struct
-{
-	uint32_t num_cheats;
-	SCheat   c[MAX_CHEATS];
-} SCheatData;
-
-SCheatData Cheat;
+INSTANCE SCheatData Cheat;
 
 static INLINE uint8_t GetByteFree(uint32_t address)
 {
 	uint32_t Cycles = CPU.Cycles;
-	uint16_t WaitPC = CPU.WaitPC;
-	uint8_t byte = GetByte(address);
-	CPU.WaitPC = WaitPC;
+	bool     Clean  = IdleLoop.Clean;
+	uint8_t  byte   = GetByte(address);
+	IdleLoop.Clean = Clean;
 	CPU.Cycles = Cycles;
 	return byte;
 }
@@ -36,9 +23,9 @@ static INLINE uint8_t GetByteFree(uint32_t address)
 static INLINE void SetByteFree(uint8_t byte, uint32_t address)
 {
 	uint32_t Cycles = CPU.Cycles;
-	uint16_t WaitPC = CPU.WaitPC;
+	bool     Clean  = IdleLoop.Clean;
 	SetByte(byte, address);
-	CPU.WaitPC = WaitPC;
+	IdleLoop.Clean = Clean;
 	CPU.Cycles = Cycles;
 }
 
@@ -177,7 +164,17 @@ void ApplyCheats()
 		}
 
 		if (ptr >= (uint8_t*) MAP_LAST)
+		{
+			if (Memory.BlockIsROM[block] && ptr[address & 0xffff] != Cheat.c[i].byte)
+			{
+				InvalidateCPUBlocks();
+				FxInvalidateBlocks();
+				FlushSDD1Cache();
+				spc7110dec_flush();
+			}
+
 			ptr[address & 0xffff] = Cheat.c[i].byte;
+		}
 		else
 			SetByteFree(Cheat.c[i].byte, address);
 	}
@@ -197,7 +194,17 @@ void RemoveCheats()
 			continue;
 
 		if (ptr >= (uint8_t*) MAP_LAST)
+		{
+			if (Memory.BlockIsROM[block] && ptr[address & 0xffff] != Cheat.c[i].saved_byte)
+			{
+				InvalidateCPUBlocks();
+				FxInvalidateBlocks();
+				FlushSDD1Cache();
+				spc7110dec_flush();
+			}
+
 			ptr[address & 0xffff] = Cheat.c[i].saved_byte;
+		}
 		else
 			SetByteFree(Cheat.c[i].saved_byte, address);
 	}
@@ -1,6 +1,29 @@
 #ifndef CHIMERASNES_CHEATS_H_
 #define CHIMERASNES_CHEATS_H_
 
+#define MAX_CHEATS 800
+
+typedef struct
+{
+	bool     saved        : 1;
+	int16_t  _SCheat_PAD1 : 15;
+	uint8_t  byte;
+	uint8_t  saved_byte;
+	uint32_t address;
+} SCheat;
+
+typedef struct
+{
+	uint32_t num_cheats;
+	SCheat   c[MAX_CHEATS];
+} SCheatData;
+
+#ifdef MULTI_INSTANCE
+	#define Cheat (*CheatPtr)
+#endif
+
+extern INSTANCE SCheatData Cheat;
+
 void AddCheat(const char* code);
 void ApplyCheats();
 void RemoveCheats();
@@ -7,6 +7,7 @@
 
 #include "port.h"
 #include "65c816.h"
+#include "perf.h"
 
 #define ROM_NAME_LEN        (22 + 1)
 #define ROM_ID_LEN          (4 + 1)
@@ -176,12 +177,16 @@ typedef struct
 	bool     SecretOfEvermoreHack : 1;
 	bool     GetSetDMATimingHacks : 1;
 	bool     LoadBSXBIOS          : 1;
-	uint8_t  _SSettings_PAD1      : 1;
+	bool     SA1Slices            : 1;
+	bool     SuperFXSlices        : 1;
+	bool     SkipUnchangedFrames  : 1;
+	uint8_t  _SSettings_PAD1      : 6;
 	uint8_t  OneCycle;
 	uint8_t  SlowOneCycle;
 	uint8_t  TwoCycles;
 	uint8_t  ControllerOption;
 	uint8_t  Chip;
+	uint8_t  RenderThreads;
 	uint16_t SuperFXSpeedPerLine;
 	int32_t  H_Max;
 	int32_t  HBlankStart;
@@ -195,10 +200,17 @@ typedef struct
 	uint32_t t64Cnt;
 } SEXTState;
 
-extern SEXTState EXT;
-extern SSettings Settings;
-extern SCPUState CPU;
-extern bool finishedFrame;
+#ifdef MULTI_INSTANCE
+	#define EXT           (*EXTPtr)
+	#define Settings      (*SettingsPtr)
+	#define CPU           (*CPUPtr)
+	#define finishedFrame (*finishedFramePtr)
+#endif
+
+extern INSTANCE SEXTState EXT;
+extern INSTANCE SSettings Settings;
+extern INSTANCE SCPUState CPU;
+extern INSTANCE bool finishedFrame;
 
 void SetPause(uint32_t mask);
 void ClearPause(uint32_t mask);
@@ -0,0 +1,238 @@
+#include <time.h>
+#include <libretro.h>
+
+#include "chisnes.h"
+#include "apu.h"
+#include "bsx.h"
+#include "cheats.h"
+#include "context.h"
+#include "cpuexec.h"
+#include "dma.h"
+#include "dsp.h"
+#include "fxemu.h"
+#include "fxinst.h"
+#include "gfx.h"
+#include "gfxthread.h"
+#include "memmap.h"
+#include "obc1.h"
+#include "ppu.h"
+#include "rewind.h"
+#include "sa1.h"
+#include "sdd1.h"
+#include "seta.h"
+#include "snesapu.h"
+#include "soundux.h"
+#include "spc7110.h"
+#include "spc7110dec.h"
+#include "srtc.h"
+#include "tile.h"
+
+typedef void    (*VoidFunc)();
+typedef uint8_t (*GetSETAFunc)(uint32_t);
+typedef void    (*SetSETAFunc)(uint8_t, uint32_t);
+typedef uint8_t (*GetDSPFunc)(uint16_t);
+typedef void    (*SetDSPFunc)(uint8_t, uint16_t);
+typedef uint8_t (*ConvertTileFunc)(uint8_t*, uint32_t);
+
+#ifdef THREADED_RENDER
+	#define RENDER_THREAD_STATE(X) X(SRenderThread*, RenderThread, )
+#else
+	#define RENDER_THREAD_STATE(X)
+#endif
+
+/* Every piece of state that belongs to one console, with the type and array
+ * dimensions it is declared with. The file static ones are only visible to
+ * the module that declares them, see STATIC_INSTANCE. */
+#define CONTEXT_STATE(X)                                        \
+	/* globals.c */                                             \
+	X(VoidFunc,            MainLoop,                  )         \
+	X(SCPUState,           CPU,                       )         \
+	X(SICPU,               ICPU,                      )         \
+	X(SCPUBlock*,          CPUBlocks,                 )         \
+	X(SIdleLoop,           IdleLoop,                  )         \
+	X(SAPU,                APU,                       )         \
+	X(SIAPU,               IAPU,                      )         \
+	X(SSoundData,          SoundData,                 )         \
+	X(SEXTState,           EXT,                       )         \
+	X(SSettings,           Settings,                  )         \
+	X(SDSP0,               DSP0,                      )         \
+	X(SDSP1,               DSP1,                      )         \
+	X(SDSP2,               DSP2,                      )         \
+	X(SDSP3,               DSP3,                      )         \
+	X(SDSP4,               DSP4,                      )         \
+	X(SSA1,                SA1,                       )         \
+	X(SRTCData,            RTCData,                   )         \
+	X(SOBC1,               OBC1,                      )         \
+	X(FXRegs_s,            FXRegs,                    )         \
+	X(FXInfo_s,            SuperFX,                   )         \
+	X(SFXBlock*,           FXBlocks,                  )         \
+	X(SBSX,                BSX,                       )         \
+	X(SetSETAFunc,         SetSETA,                   )         \
+	X(GetSETAFunc,         GetSETA,                   )         \
+	X(CMemory*,            MemoryPtr,                 )         \
+	X(SPPU,                PPU,                       )         \
+	X(InternalPPU,         IPPU,                      )         \
+	X(ConvertTileFunc,     ConvertTile,               )         \
+	X(SDMA,                DMA,                       [8])      \
+	X(uint8_t*,            HDMAMemPointers,           [8])      \
+	X(uint8_t*,            HDMABasePointers,          [8])      \
+	X(SGFX,                GFX,                       )         \
+	X(SLineData,           LineData,                  [240])    \
+	X(SLineMatrixData,     LineMatrixData,            [240])    \
+	X(uint8_t,             Mode7Depths,               [2])      \
+	X(SScreenSnapshot,     ScreenSnapshot,            )         \
+	X(NormalTileRenderer,  DrawTilePtr,               )         \
+	X(ClippedTileRenderer, DrawClippedTilePtr,        )         \
+	X(NormalTileRenderer,  DrawHiResTilePtr,          )         \
+	X(ClippedTileRenderer, DrawHiResClippedTilePtr,   )         \
+	X(LargePixelRenderer,  DrawLargePixelPtr,         )         \
+	X(bool,                finishedFrame,             )         \
+	X(int32_t,             Echo,                      [ECHOBUF]) \
+	X(int8_t,              FilterTaps,                [8])      \
+	X(int16_t,             Loop,                      [FIRBUF]) \
+	X(uint16_t,            DirectColourMaps,          [8][256]) \
+	X(uint8_t,             APUCycles,                 [256])    \
+	RENDER_THREAD_STATE(X)                                      \
+	X(SRewind*,            Rewind,                    )         \
+	/* Coprocessors and peripherals */                          \
+	X(SCheatData,          Cheat,                     )         \
+	X(SST010,              ST010,                     )         \
+	X(SPC7110Regs,         s7r,                       )         \
+	X(S7RTC,               rtc_f9,                    )         \
+	X(SPC7110Decomp,       decomp,                    )         \
+	X(SSDD1Cache,          SDD1Cache,                 )         \
+	X(SSRTCSnap,           srtcsnap,                  )         \
+	X(GetDSPFunc,          GetDSP,                    )         \
+	X(SetDSPFunc,          SetDSP,                    )         \
+	X(VoidFunc,            SetDSP3,                   )         \
+	X(uint32_t,            FlashSize,                 )         \
+	X(uint8_t*,            MapROM,                    )         \
+	X(uint8_t*,            FlashROM,                  )         \
+	X(time_t,              RTCTime,                   )         \
+	X(uint32_t,            justifiers,                )         \
+	X(uint8_t,             in_bit,                    )         \
+	X(bool,                last_p1,                   )         \
+	X(int16_t,             CX4WFXVal,                 )         \
+	X(int16_t,             CX4WFYVal,                 )         \
+	X(int16_t,             CX4WFZVal,                 )         \
+	X(int16_t,             CX4WFX2Val,                )         \
+	X(int16_t,             CX4WFY2Val,                )         \
+	X(int16_t,             CX4WFDist,                 )         \
+	X(int16_t,             CX4WFScale,                )         \
+	X(int16_t,             CX41FXVal,                 )         \
+	X(int16_t,             CX41FYVal,                 )         \
+	X(int16_t,             CX41FAngleRes,             )         \
+	X(int16_t,             CX41FDist,                 )         \
+	X(int16_t,             CX41FDistVal,              )         \
+	X(int32_t,             tanval,                    )         \
+	X(int32_t,             cx4x,                      )         \
+	X(int32_t,             cx4y,                      )         \
+	X(int32_t,             cx4z,                      )         \
+	X(int32_t,             cx4x2,                     )         \
+	X(int32_t,             cx4y2,                     )         \
+	X(int32_t,             cx4z2,                     )         \
+	/* snesapu.c */                                             \
+	X(VoiceMix,            mix,                       [8])      \
+	X(uint8_t,             voiceKon,                  )         \
+	X(uint32_t,            rateTab,                   [32])     \
+	X(int32_t,             dspRate,                   )         \
+	X(uint32_t,            pitchAdj,                  )         \
+	X(int32_t,             volAdj,                    )         \
+	X(int32_t,             volMainL,                  )         \
+	X(int32_t,             volMainR,                  )         \
+	X(int32_t,             volEchoL,                  )         \
+	X(int32_t,             volEchoR,                  )         \
+	X(uint32_t,            echoStart,                 )         \
+	X(uint32_t,            echoDel,                   )         \
+	X(uint32_t,            echoCur,                   )         \
+	X(int32_t,             echoFB,                    )         \
+	X(uint32_t,            echoEnd,                   )         \
+	X(int32_t,             nSmp,                      )         \
+	X(int16_t,             nDec,                      )         \
+	X(int16_t,             nRate,                     )         \
+	X(uint8_t,             firCur,                    )         \
+	X(uint8_t,             disEcho,                   )         \
+	X(SBRRBlock,           brrCache,                  [BRR_CACHE_SIZE]) \
+	/* libretro.c */                                            \
+	X(retro_log_printf_t,         log_cb,                     ) \
+	X(retro_video_refresh_t,      video_cb,                   ) \
+	X(retro_input_poll_t,         poll_cb,                    ) \
+	X(retro_input_state_t,        input_cb,                   ) \
+	X(retro_audio_sample_batch_t, audio_batch_cb,             ) \
+	X(retro_environment_t,        environ_cb,                 ) \
+	X(bool,     libretro_supports_option_categories,          ) \
+	X(bool,     libretro_supports_bitmasks,                   ) \
+	X(int16_t*, audio_out_buffer,                             ) \
+	X(float,    audio_samples_per_frame,                      ) \
+	X(float,    audio_samples_accumulator,                    ) \
+	X(uint8_t,  frameskip_type,                               ) \
+	X(uint8_t,  frameskip_threshold,                          ) \
+	X(bool,     retro_audio_buff_active,                      ) \
+	X(uint8_t,  retro_audio_buff_occupancy,                   ) \
+	X(bool,     retro_audio_buff_underrun,                    ) \
+	X(unsigned, retro_audio_latency,                          ) \
+	X(bool,     update_audio_latency,                         ) \
+	X(bool,     mute_audio,                                   ) \
+	X(uint32_t, rewind_seconds,                               ) \
+	X(uint8_t*, rewind_state,                                 )
+
+/* The names are only ever pasted, so the mappings to (*namePtr) in the
+ * headers do not apply here. */
+#define CONTEXT_EXTERN(type, name, dims) extern THREAD_LOCAL type (*name##Ptr) dims;
+#define CONTEXT_FIELD(type, name, dims)  type name##_ dims;
+#define CONTEXT_BIND(type, name, dims)   name##Ptr = ctx ? &ctx->name##_ : NULL;
+
+CONTEXT_STATE(CONTEXT_EXTERN)
+
+struct SContext
+{
+	CONTEXT_STATE(CONTEXT_FIELD)
+};
+
+static uint32_t ContextCount;
+static THREAD_LOCAL SContext* BoundContext;
+
+SContext* CreateContext()
+{
+	SContext* ctx;
+
+	/* Built here rather than in retro_init so that contexts initialised
+	 * concurrently only ever read them */
+	if (!InitGFXTables())
+		return NULL;
+
+	InitAPUDSPTables();
+	ctx = (SContext*) calloc(1, sizeof(SContext));
+
+	if (ctx)
+		ContextCount++;
+	else if (ContextCount == 0)
+		DeinitGFXTables();
+
+	return ctx;
+}
+
+void DestroyContext(SContext* ctx)
+{
+	if (!ctx)
+		return;
+
+	if (BoundContext == ctx)
+		BindContext(NULL);
+
+	free(ctx);
+
+	if (--ContextCount == 0)
+		DeinitGFXTables();
+}
+
+void BindContext(SContext* ctx)
+{
+	BoundContext = ctx;
+	CONTEXT_STATE(CONTEXT_BIND)
+}
+
+SContext* GetContext()
+{
+	return BoundContext;
+}
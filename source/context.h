@@ -0,0 +1,21 @@
+#ifndef CHIMERASNES_CONTEXT_H_
+#define CHIMERASNES_CONTEXT_H_
+
+/* A context holds one emulated console. Only MULTI_INSTANCE builds have them.
+ *
+ * CreateContext() and DestroyContext() must be called from one thread at a
+ * time. Everything else runs on whichever context the calling thread bound
+ * with BindContext(), so several contexts can run concurrently as long as
+ * each of them is only bound to one thread at a time. The libretro entry
+ * points (retro_init, retro_load_game, retro_run, ...) are the step API:
+ * bind a context and call them as a frontend would. Call retro_deinit while
+ * it is still bound before destroying a context. */
+#ifdef MULTI_INSTANCE
+	typedef struct SContext SContext;
+
+	SContext* CreateContext();
+	void      DestroyContext(SContext* ctx);
+	void      BindContext(SContext* ctx);
+	SContext* GetContext();
+#endif
+#endif
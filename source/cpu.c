@@ -16,6 +16,7 @@
 
 void ResetCPU()
 {
+	InvalidateCPUBlocks();
 	ICPU.Registers.PBPC = GetWord(0xfffc, WRAP_NONE);
 	ICPU.Registers.D.W = 0;
 	ICPU.Registers.DB = 0;
@@ -37,6 +38,7 @@ void ResetCPU()
 	CPU.PCAtOpcodeStart = 0;
 	CPU.WaitPC = 0;
 	CPU.WaitCounter = 1;
+	IdleLoop.Clean = false;
 	CPU.V_Counter = 0;
 	CPU.Cycles = 182; /* This is the cycle count just after the jump to the Reset Vector. */
 	CPU.WhichEvent = HBLANK_START_EVENT;
@@ -53,10 +55,8 @@ void ResetCPU()
 	UnpackStatus();
 }
 
-static void CommonReset()
+static void ResetChips()
 {
-	memset(Memory.VRAM, 0x00, 0x10000);
-
 	if ((Settings.Chip & BS) == BS)
 		ResetBSX();
 	else if ((Settings.Chip & DSP) == DSP)
@@ -75,7 +75,12 @@ static void CommonReset()
 		ResetOBC1();
 	else if (Settings.Chip == S_RTC)
 		ResetSRTC();
+}
 
+static void CommonReset()
+{
+	memset(Memory.VRAM, 0x00, 0x10000);
+	ResetChips();
 	ResetCPU();
 	ResetDMA();
 	ResetAPU();
@@ -89,6 +94,17 @@ void Reset()
 	CommonReset();
 }
 
+/* Reset() for loading a state saved by this same console, such as the one run-ahead goes back to every frame. Memory and
+ * registers are left for the state to overwrite, and with the same ROM the instruction runs predecoded from it stay
+ * valid, so only what a state does not hold is reset. The caller invalidates the tiles and colours that change. */
+void ResetForStateLoad()
+{
+	ResetPPUForStateLoad();
+	ResetChips();
+	IdleLoop.Clean = false;
+	ResetAPU();
+}
+
 void SoftReset()
 {
 	SoftResetPPU();
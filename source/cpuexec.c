@@ -16,6 +16,7 @@
 {                                                                                                              \
 	uint8_t Op;                                                                                                \
 	SOpcodes* Opcodes;                                                                                         \
+	SCPUBlock* Block;                                                                                          \
 	                                                                                                           \
 	do                                                                                                         \
 	{                                                                                                          \
@@ -66,7 +67,44 @@
 			                                                                                                   \
 			if (CPU.PCBase)                                                                                    \
 			{                                                                                                  \
-				Op = CPU.PCBase[ICPU.Registers.PCw];                                                           \
+				uint8_t* Code = CPU.PCBase + ICPU.Registers.PCw;                                               \
+				Block = &CPUBlocks[CPU_BLOCK_HASH(Code)];                                                      \
+				                                                                                               \
+				if (Block->Code != Code || Block->Opcodes != ICPU.Opcodes)                                     \
+					Block = DecodeCPUBlock(Block, Code);                                                       \
+				                                                                                               \
+				if (Block->Ops[0])                                                                             \
+				{                                                                                              \
+					uint8_t* PCBase = CPU.PCBase;                                                              \
+					int32_t  i = 0;                                                                            \
+					                                                                                           \
+					do                                                                                         \
+					{                                                                                          \
+						CPU.Cycles += CPU.MemSpeed;                                                            \
+						ICPU.Registers.PCw++;                                                                  \
+						(*Block->Ops[i])();                                                                    \
+						PERF_COUNT(PERF_CPU_OPS, 1);                                                           \
+						SA1_MAIN_LOOP;                                                                         \
+						                                                                                       \
+						if (CPU.Cycles >= CPU.NextEvent)                                                       \
+							HBLANK_PROCESSING;                                                                 \
+						                                                                                       \
+						if (finishedFrame || CPU.Flags || ICPU.Registers.PCw != Block->NextPC[i] || !Block->Ops[++i])\
+							break;                                                                             \
+						                                                                                       \
+						if (CPU.PCBase != PCBase || ICPU.Opcodes != Block->Opcodes)                            \
+							break;                                                                             \
+						                                                                                       \
+						CPU.PCAtOpcodeStart = ICPU.Registers.PCw;                                              \
+					} while (true);                                                                            \
+					                                                                                           \
+					if (finishedFrame)                                                                         \
+						break;                                                                                 \
+					                                                                                           \
+					continue;                                                                                  \
+				}                                                                                              \
+				                                                                                               \
+				Op = *Code;                                                                                    \
 				CPU.Cycles += CPU.MemSpeed;                                                                    \
 				Opcodes = ICPU.Opcodes;                                                                        \
 			}                                                                                                  \
@@ -88,6 +126,7 @@
 			                                                                                                   \
 			ICPU.Registers.PCw++;                                                                              \
 			(*Opcodes[Op].Opcode)();                                                                           \
+			PERF_COUNT(PERF_CPU_OPS, 1);                                                                       \
 			SA1_MAIN_LOOP;                                                                                     \
 			                                                                                                   \
 			if (CPU.Cycles >= CPU.NextEvent)                                                                   \
@@ -95,8 +134,6 @@
 			                                                                                                   \
 			if (finishedFrame)                                                                                 \
 				break;                                                                                         \
-			                                                                                                   \
-			APUExecute();                                                                                      \
 		} while (true);                                                                                        \
 		                                                                                                       \
 		IAPU.Registers.PC = IAPU.PC - IAPU.RAM;                                                                \
@@ -126,9 +163,20 @@ static void MainLoop_SA1()
 	)
 }
 
+/* The SA-1 runs in slices, see SA1CatchUp */
+static void MainLoop_SA1Slices()
+{
+	MAIN_LOOP({ SA1CatchUp(); DoHBlankProcessing_NoSFX(); },
+		SA1.CatchUpSteps++
+	)
+
+	SA1CatchUp();
+}
+
 static void MainLoop_SuperFX()
 {
 	MAIN_LOOP(DoHBlankProcessing_SFX(), )
+	SuperFXSync();
 }
 
 static void MainLoop_Fast()
@@ -139,13 +187,88 @@ static void MainLoop_Fast()
 void SetMainLoop()
 {
 	if (Settings.Chip == SA_1)
-		MainLoop = &MainLoop_SA1;
+		MainLoop = Settings.SA1Slices ? &MainLoop_SA1Slices : &MainLoop_SA1;
 	else if (Settings.Chip == GSU)
 		MainLoop = &MainLoop_SuperFX;
 	else
 		MainLoop = &MainLoop_Fast;
 }
 
+static bool EndsCPUBlock(uint8_t op) /* Control transfers and mode changes */
+{
+	switch (op)
+	{
+		case 0x00: /* BRK */
+		case 0x02: /* COP */
+		case 0x20: /* JSR */
+		case 0x22: /* JSL */
+		case 0x28: /* PLP */
+		case 0x40: /* RTI */
+		case 0x44: /* MVP */
+		case 0x4c: /* JMP */
+		case 0x54: /* MVN */
+		case 0x5c: /* JML */
+		case 0x60: /* RTS */
+		case 0x6b: /* RTL */
+		case 0x6c: /* JMP (a) */
+		case 0x7c: /* JMP (a,x) */
+		case 0x80: /* BRA */
+		case 0x82: /* BRL */
+		case 0xc2: /* REP */
+		case 0xcb: /* WAI */
+		case 0xdb: /* STP */
+		case 0xdc: /* JML [a] */
+		case 0xe2: /* SEP */
+		case 0xfb: /* XCE */
+		case 0xfc: /* JSR (a,x) */
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* Code in ROM cannot change under the CPU, so the handlers of a straight run
+ * of instructions can be looked up once. The run stops before any instruction
+ * that crosses into the next memory block, as those need the checks done by
+ * the main loop. An empty block marks code that must always be fetched. */
+SCPUBlock* DecodeCPUBlock(SCPUBlock* block, uint8_t* code)
+{
+	uint16_t pc = ICPU.Registers.PCw;
+	int32_t  i  = 0;
+	block->Code = code;
+	block->Opcodes = ICPU.Opcodes;
+
+	if (Memory.BlockIsROM[(ICPU.Registers.PBPC & 0xffffff) >> MEMMAP_SHIFT])
+	{
+		for (; i < CPU_BLOCK_MAX_OPS; i++)
+		{
+			uint8_t op = CPU.PCBase[pc];
+
+			if ((pc & MEMMAP_MASK) + ICPU.OpLengths[op] >= MEMMAP_BLOCK_SIZE)
+				break;
+
+			block->Ops[i] = ICPU.Opcodes[op].Opcode;
+			pc += ICPU.OpLengths[op];
+			block->NextPC[i] = pc;
+
+			if (EndsCPUBlock(op))
+			{
+				i++;
+				break;
+			}
+		}
+	}
+
+	block->Ops[i] = NULL;
+	return block;
+}
+
+void InvalidateCPUBlocks() /* Must be called whenever the contents of ROM change */
+{
+	if (CPUBlocks)
+		memset(CPUBlocks, 0, CPU_BLOCK_COUNT * sizeof(SCPUBlock));
+}
+
 void SetIRQSource(uint32_t source)
 {
 	CPU.IRQActive |= source;
@@ -174,7 +297,7 @@ void ClearIRQSource(uint32_t source)
 #define DO_HBLANK_PROCESSING(SUPERFX_EXEC)                                                                                            \
 {                                                                                                                                     \
 	int32_t i;                                                                                                                        \
-	CPU.WaitCounter++;                                                                                                                \
+	IdleLoop.Clean = false; /* An iteration that spans an event proves nothing */                                                     \
 	                                                                                                                                  \
 	switch (CPU.WhichEvent)                                                                                                           \
 	{                                                                                                                                 \
@@ -185,6 +308,7 @@ void ClearIRQSource(uint32_t source)
 			break;                                                                                                                    \
 		case HBLANK_END_EVENT:                                                                                                        \
 			SUPERFX_EXEC;                                                                                                             \
+			APUExecute(); /* The SPC700 otherwise only catches up when the 65c816 accesses its ports */                               \
 			CPU.Cycles -= Settings.H_Max;                                                                                             \
 			                                                                                                                          \
 			if (IAPU.Executing)                                                                                                       \
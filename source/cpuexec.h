@@ -24,10 +24,45 @@ typedef struct
 	SOpcodes*  Opcodes;
 } SICPU;
 
-typedef void (*MainLoopPtr)();
+/* The CPU state at the head of the last loop that was entered by a backward
+ * branch. A loop that ends up where it started without writing anything or
+ * reading anything that can change before the next event is idle. */
+typedef struct
+{
+	bool       Clean           : 1; /* No writes or reads with side effects since the last visit */
+	bool       Carry           : 1;
+	bool       Overflow        : 1;
+	bool       Zero            : 1;
+	uint8_t    _SIdleLoop_PAD1 : 4;
+	uint8_t    Negative;
+	uint8_t    OpenBus;
+	SRegisters Registers;
+} SIdleLoop;
+
+#define CPU_BLOCK_MAX_OPS 16
+#define CPU_BLOCK_COUNT   4096
+#define CPU_BLOCK_HASH(code) ((((uintptr_t) (code)) ^ ((uintptr_t) (code) >> MEMMAP_SHIFT)) & (CPU_BLOCK_COUNT - 1))
+
+/* A straight run of instructions in a ROM block, predecoded for one M/X/E mode */
+typedef struct
+{
+	uint8_t*  Code;                           /* ROM address of the first opcode, NULL if unused */
+	SOpcodes* Opcodes;                        /* Opcode table the run was decoded with */
+	uint16_t  NextPC[CPU_BLOCK_MAX_OPS];      /* PC after each instruction if it does not branch */
+	void    (*Ops[CPU_BLOCK_MAX_OPS + 1])(); /* NULL terminated, empty if the code must not be cached */
+} SCPUBlock;
+
+#ifdef MULTI_INSTANCE
+	#define MainLoop  (*MainLoopPtr)
+	#define ICPU      (*ICPUPtr)
+	#define CPUBlocks (*CPUBlocksPtr)
+	#define IdleLoop  (*IdleLoopPtr)
+#endif
 
-extern MainLoopPtr MainLoop;
-extern SICPU       ICPU;
+extern INSTANCE void      (*MainLoop)();
+extern INSTANCE SICPU      ICPU;
+extern INSTANCE SCPUBlock* CPUBlocks;
+extern INSTANCE SIdleLoop  IdleLoop;
 
 extern SOpcodes OpcodesE1[256];
 extern SOpcodes OpcodesM1X1[256];
@@ -40,13 +75,16 @@ extern uint8_t  OpLengthsM1X0[256];
 extern uint8_t  OpLengthsM0X1[256];
 extern uint8_t  OpLengthsM0X0[256];
 
-void    SetMainLoop();
-void    Reset();
-void    SoftReset();
-void    DoHBlankProcessing_SFX();
-void    DoHBlankProcessing_NoSFX();
-void    ClearIRQSource(uint32_t source);
-void    SetIRQSource(uint32_t source);
+void       SetMainLoop();
+SCPUBlock* DecodeCPUBlock(SCPUBlock* block, uint8_t* code);
+void       InvalidateCPUBlocks();
+void       Reset();
+void       ResetForStateLoad();
+void       SoftReset();
+void       DoHBlankProcessing_SFX();
+void       DoHBlankProcessing_NoSFX();
+void       ClearIRQSource(uint32_t source);
+void       SetIRQSource(uint32_t source);
 
 static INLINE void UnpackStatus()
 {
@@ -3,10 +3,13 @@
 
 #include <retro_inline.h>
 
+/* Only the SA-1 still waits for its idle loops at a fixed address, which any DEC or INC makes it forget */
 #ifdef SA1_OPCODES
 	#define AddCycles(cycles) {}
+	#define ClearWaitPC()     CPU.WaitPC = 0
 #else
 	#define AddCycles(cycles) CPU.Cycles += cycles
+	#define ClearWaitPC()
 #endif
 
 static INLINE void SetZN16(uint16_t Work16)
@@ -214,7 +217,7 @@ static INLINE void CPY8(uint8_t val)
 static INLINE void DEC16(uint32_t OpAddress, wrap_t w)
 {
 	uint16_t Work16;
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	Work16 = GetWord(OpAddress, w) - 1;
 	AddCycles(Settings.OneCycle);
 	SetWord(Work16, OpAddress, w, WRITE_10);
@@ -225,7 +228,7 @@ static INLINE void DEC16(uint32_t OpAddress, wrap_t w)
 static INLINE void DEC8(uint32_t OpAddress)
 {
 	uint8_t Work8;
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	Work8 = GetByte(OpAddress) - 1;
 	AddCycles(Settings.OneCycle);
 	SetByte(Work8, OpAddress);
@@ -248,7 +251,7 @@ static INLINE void EOR8(uint8_t val)
 static INLINE void INC16(uint32_t OpAddress, wrap_t w)
 {
 	uint16_t Work16;
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	Work16 = GetWord(OpAddress, w) + 1;
 	AddCycles(Settings.OneCycle);
 	SetWord(Work16, OpAddress, w, WRITE_10);
@@ -259,7 +262,7 @@ static INLINE void INC16(uint32_t OpAddress, wrap_t w)
 static INLINE void INC8(uint32_t OpAddress)
 {
 	uint8_t Work8;
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	Work8 = GetByte(OpAddress) + 1;
 	AddCycles(Settings.OneCycle);
 	SetByte(Work8, OpAddress);
@@ -150,32 +150,83 @@ static INLINE void ForceShutdown() /* From the speed-hacks branch of CatSFC */
 #ifdef SA1_OPCODES
 	SA1.Executing = false;
 #else
-	CPU.WaitPC = 0;
 	CPU.Cycles = CPU.NextEvent;
 #endif
 }
 
+#ifndef SA1_OPCODES
+static INLINE bool SameIdleState()
+{
+	return IdleLoop.Registers.PC.xPBPC == ICPU.Registers.PC.xPBPC &&
+	       IdleLoop.Registers.A.W      == ICPU.Registers.A.W      &&
+	       IdleLoop.Registers.X.W      == ICPU.Registers.X.W      &&
+	       IdleLoop.Registers.Y.W      == ICPU.Registers.Y.W      &&
+	       IdleLoop.Registers.D.W      == ICPU.Registers.D.W      &&
+	       IdleLoop.Registers.S.W      == ICPU.Registers.S.W      &&
+	       IdleLoop.Registers.P.W      == ICPU.Registers.P.W      &&
+	       IdleLoop.Registers.DB       == ICPU.Registers.DB       &&
+	       IdleLoop.Carry              == ICPU.Carry              &&
+	       IdleLoop.Overflow           == ICPU.Overflow           &&
+	       IdleLoop.Zero               == ICPU.Zero               &&
+	       IdleLoop.Negative           == ICPU.Negative           &&
+	       IdleLoop.OpenBus            == ICPU.OpenBus;
+}
+
+/* The SA-1 runs for as long as the SNES CPU does, so skipping the latter ahead
+ * would take time away from the former unless it is asleep. When it runs in
+ * slices, it first catches up to see whether it fell asleep, and an iteration
+ * that it wrote to memory in the meantime no longer counts. */
+static INLINE bool SA1AllowsSkip()
+{
+	if (Settings.Chip != SA_1)
+		return true;
+
+	if (SA1.CatchUpSteps)
+		SA1CatchUp();
+
+	return IdleLoop.Clean && SA1Asleep();
+}
+
+/* Called when a backward branch or jump is taken. If a whole iteration of the loop
+ * only read memory that nothing but an event can change and left every
+ * register as it was, all iterations until the next event will do the
+ * same, so they can be skipped. */
+static INLINE void CheckIdleLoop()
+{
+	if (IdleLoop.Clean && SameIdleState())
+	{
+		/* Don't skip cycles with a pending NMI or IRQ - could cause delayed
+		 * interrupt. Was causing screen flashing on Top Gear 3000. */
+		if (!(CPU.Flags & (IRQ_FLAG | NMI_FLAG)) && CPU.Cycles < CPU.NextEvent && SA1AllowsSkip())
+			CPU.Cycles = CPU.NextEvent;
+	}
+	else
+	{
+		IdleLoop.Registers = ICPU.Registers;
+		IdleLoop.Carry     = ICPU.Carry;
+		IdleLoop.Overflow  = ICPU.Overflow;
+		IdleLoop.Zero      = ICPU.Zero;
+		IdleLoop.Negative  = ICPU.Negative;
+		IdleLoop.OpenBus   = ICPU.OpenBus;
+	}
+
+	IdleLoop.Clean = true;
+}
+#endif
+
 static INLINE void CPUShutdown()
 {
+#ifdef SA1_OPCODES
 	if (!Settings.Shutdown || ICPU.Registers.PCw != CPU.WaitPC)
 		return;
 
-#ifdef SA1_OPCODES
 	if (SA1.WaitCounter >= 1)
 		ForceShutdown();
 	else
 		SA1.WaitCounter++;
 #else
-	/* Don't skip cycles with a pending NMI or IRQ - could cause delayed
-	 * interrupt. Interrupts are delayed for a few cycles already, but
-	 * the delay could allow the shutdown code to cycle skip again.
-	 * Was causing screen flashing on Top Gear 3000. */
-	if (CPU.WaitCounter == 0 && !(CPU.Flags & (IRQ_FLAG | NMI_FLAG)))
-		ForceShutdown();
-	else if (CPU.WaitCounter >= 2)
-		CPU.WaitCounter = 1;
-	else
-		CPU.WaitCounter--;
+	if (ICPU.Registers.PCw <= CPU.PCAtOpcodeStart)
+		CheckIdleLoop();
 #endif
 }
 
@@ -628,7 +679,7 @@ rOpX (CCSlow,   AbsoluteSlow,                     WRAP_NONE, CPY)
 static void Op3AM1()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.AL--;
 	SetZN8(ICPU.Registers.AL);
 }
@@ -636,7 +687,7 @@ static void Op3AM1()
 static void Op3AM0()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.A.W--;
 	SetZN16(ICPU.Registers.A.W);
 }
@@ -644,7 +695,7 @@ static void Op3AM0()
 static void Op3ASlow()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 
 	if (CheckMem())
 	{
@@ -774,7 +825,7 @@ rOpM (53Slow,   StackRelativeIndirectIndexedSlow, WRAP_NONE, EOR)
 static void Op1AM1()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.AL++;
 	SetZN8(ICPU.Registers.AL);
 }
@@ -782,7 +833,7 @@ static void Op1AM1()
 static void Op1AM0()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.A.W++;
 	SetZN16(ICPU.Registers.A.W);
 }
@@ -790,7 +841,7 @@ static void Op1AM0()
 static void Op1ASlow()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 
 	if (CheckMem())
 	{
@@ -1564,7 +1615,7 @@ static void OpB8() /* CLV */
 static void OpCAX1()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.XL--;
 	SetZN8(ICPU.Registers.XL);
 }
@@ -1572,7 +1623,7 @@ static void OpCAX1()
 static void OpCAX0()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.X.W--;
 	SetZN16(ICPU.Registers.X.W);
 }
@@ -1580,7 +1631,7 @@ static void OpCAX0()
 static void OpCASlow()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 
 	if (CheckIndex())
 	{
@@ -1597,7 +1648,7 @@ static void OpCASlow()
 static void Op88X1()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.YL--;
 	SetZN8(ICPU.Registers.YL);
 }
@@ -1605,7 +1656,7 @@ static void Op88X1()
 static void Op88X0()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.Y.W--;
 	SetZN16(ICPU.Registers.Y.W);
 }
@@ -1613,7 +1664,7 @@ static void Op88X0()
 static void Op88Slow()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 
 	if (CheckIndex())
 	{
@@ -1631,7 +1682,7 @@ static void Op88Slow()
 static void OpE8X1()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.XL++;
 	SetZN8(ICPU.Registers.XL);
 }
@@ -1639,7 +1690,7 @@ static void OpE8X1()
 static void OpE8X0()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.X.W++;
 	SetZN16(ICPU.Registers.X.W);
 }
@@ -1647,7 +1698,7 @@ static void OpE8X0()
 static void OpE8Slow()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 
 	if (CheckIndex())
 	{
@@ -1664,7 +1715,7 @@ static void OpE8Slow()
 static void OpC8X1()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.YL++;
 	SetZN8(ICPU.Registers.YL);
 }
@@ -1672,7 +1723,7 @@ static void OpC8X1()
 static void OpC8X0()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 	ICPU.Registers.Y.W++;
 	SetZN16(ICPU.Registers.Y.W);
 }
@@ -1680,7 +1731,7 @@ static void OpC8X0()
 static void OpC8Slow()
 {
 	AddCycles(Settings.OneCycle);
-	CPU.WaitPC = 0;
+	ClearWaitPC();
 
 	if (CheckIndex())
 	{
@@ -2799,19 +2850,13 @@ static void Op5CSlow()
 static void Op4C()
 {
 	SetPCBase(ICPU.ShiftedPB + ((uint16_t) Absolute(JUMP)));
-
-#ifdef SA1_OPCODES
 	CPUShutdown();
-#endif
 }
 
 static void Op4CSlow()
 {
 	SetPCBase(ICPU.ShiftedPB + ((uint16_t) AbsoluteSlow(JUMP)));
-
-#ifdef SA1_OPCODES
 	CPUShutdown();
-#endif
 }
 
 static void Op6C()
@@ -3008,18 +3053,98 @@ static void Op60Slow()
 }
 
 /* MVN/MVP */
+#ifndef SA1_OPCODES
+/* MVN and MVP move one byte each time they run and run again until A wraps. Once a byte has been moved between plain
+ * memory, the bytes that the next runs would move before the next event are moved right away, one by one so that
+ * overlapping blocks come out the same. The memory speed is the same within 512 bytes, so every run takes as long as
+ * the first. The SA-1 runs alongside the CPU and can see the bytes in between, so it does not get this. */
+static INLINE uint32_t MoveRoom(uint32_t count, uint32_t offset, uint32_t size, int32_t step) /* Before offset leaves size */
+{
+	uint32_t room = step > 0 ? size - offset : offset + 1;
+	return count < room ? count : room;
+}
+
+static INLINE void MoveBlockAhead(uint32_t src, uint32_t dst, int32_t step, bool index8, int32_t cycles)
+{
+	uint32_t next_src = (src & 0xff0000) + ICPU.Registers.X.W;
+	uint32_t next_dst = ICPU.ShiftedDB + ICPU.Registers.Y.W;
+	int32_t  start    = CPU.Cycles + Settings.TwoCycles; /* When the next run would start */
+	int32_t  per      = 3 * CPU.MemSpeed + cycles + Settings.TwoCycles;
+	uint8_t* from     = Memory.Map[next_src >> MEMMAP_SHIFT];
+	uint8_t* to       = Memory.WriteMap[next_dst >> MEMMAP_SHIFT];
+	uint8_t* code     = CPU.PCBase + CPU.PCAtOpcodeStart;
+	uint32_t count    = ICPU.Registers.A.W + 1;
+	uint32_t i;
+
+	if (ICPU.Registers.A.W == 0xffff || CPU.Flags || Settings.Chip == SA_1 || !CPU.PCBase || start >= CPU.NextEvent)
+		return;
+
+	if (from < (uint8_t*) MAP_LAST || to < (uint8_t*) MAP_LAST || ((next_src ^ src) | (next_dst ^ dst)) & ~0x1ff)
+		return;
+
+	from += next_src & 0xffff;
+	to   += next_dst & 0xffff;
+
+	/* Stop at the end of the 512 bytes, or where an 8 bit index would wrap */
+	count = MoveRoom(count, next_src & 0x1ff, 0x200, step);
+	count = MoveRoom(count, next_dst & 0x1ff, 0x200, step);
+
+	if (index8)
+	{
+		count = MoveRoom(count, ICPU.Registers.XL, 0x100, step);
+		count = MoveRoom(count, ICPU.Registers.YL, 0x100, step);
+	}
+
+	if (count > (uint32_t) ((CPU.NextEvent - start + per - 1) / per))
+		count = (CPU.NextEvent - start + per - 1) / per;
+
+	/* Unless the bytes moved, including the first one, overwrite the instruction */
+	if (step > 0 ? (to < code + 4 && to + count > code) : (to + 1 >= code && to < code + 2 + count))
+		return;
+
+	if (step > 0)
+		for (i = 0; i < count; i++)
+			to[i] = from[i];
+	else
+		for (i = 0; i < count; i++)
+			*(to - i) = *(from - i);
+
+	ICPU.OpenBus = step > 0 ? to[count - 1] : *(to - (count - 1));
+	ICPU.Registers.A.W -= count;
+
+	if (index8)
+	{
+		ICPU.Registers.XL += step * (int32_t) count;
+		ICPU.Registers.YL += step * (int32_t) count;
+	}
+	else
+	{
+		ICPU.Registers.X.W += step * (int32_t) count;
+		ICPU.Registers.Y.W += step * (int32_t) count;
+	}
+
+	CPU.Cycles += count * per;
+	PERF_COUNT(PERF_CPU_OPS, count);
+}
+#endif
+
 static void Op54X1()
 {
-	uint32_t SrcBank;
+	uint32_t SrcBank, Src, Dst;
+	NOT_SA1(int32_t Cycles);
 	ICPU.Registers.DB = Immediate8(NONE);
 	ICPU.ShiftedDB = ICPU.Registers.DB << 16;
 	ICPU.OpenBus = SrcBank = Immediate8(NONE);
-	ICPU.OpenBus = GetByte((SrcBank << 16) + ICPU.Registers.X.W);
-	SetByte(ICPU.OpenBus, ICPU.ShiftedDB + ICPU.Registers.Y.W);
+	Src = (SrcBank << 16) + ICPU.Registers.X.W;
+	Dst = ICPU.ShiftedDB + ICPU.Registers.Y.W;
+	NOT_SA1(Cycles = CPU.Cycles);
+	ICPU.OpenBus = GetByte(Src);
+	SetByte(ICPU.OpenBus, Dst);
 
 	ICPU.Registers.XL++;
 	ICPU.Registers.YL++;
 	ICPU.Registers.A.W--;
+	NOT_SA1(MoveBlockAhead(Src, Dst, 1, true, CPU.Cycles - Cycles));
 
 	if (ICPU.Registers.A.W != 0xffff)
 		ICPU.Registers.PCw -= 3;
@@ -3029,16 +3154,21 @@ static void Op54X1()
 
 static void Op54X0()
 {
-	uint32_t SrcBank;
+	uint32_t SrcBank, Src, Dst;
+	NOT_SA1(int32_t Cycles);
 	ICPU.Registers.DB = Immediate8(NONE);
 	ICPU.ShiftedDB = ICPU.Registers.DB << 16;
 	ICPU.OpenBus = SrcBank = Immediate8(NONE);
-	ICPU.OpenBus = GetByte((SrcBank << 16) + ICPU.Registers.X.W);
-	SetByte(ICPU.OpenBus, ICPU.ShiftedDB + ICPU.Registers.Y.W);
+	Src = (SrcBank << 16) + ICPU.Registers.X.W;
+	Dst = ICPU.ShiftedDB + ICPU.Registers.Y.W;
+	NOT_SA1(Cycles = CPU.Cycles);
+	ICPU.OpenBus = GetByte(Src);
+	SetByte(ICPU.OpenBus, Dst);
 
 	ICPU.Registers.X.W++;
 	ICPU.Registers.Y.W++;
 	ICPU.Registers.A.W--;
+	NOT_SA1(MoveBlockAhead(Src, Dst, 1, false, CPU.Cycles - Cycles));
 
 	if (ICPU.Registers.A.W != 0xffff)
 		ICPU.Registers.PCw -= 3;
@@ -3076,15 +3206,20 @@ static void Op54Slow()
 
 static void Op44X1()
 {
-	uint32_t SrcBank;
+	uint32_t SrcBank, Src, Dst;
+	NOT_SA1(int32_t Cycles);
 	ICPU.Registers.DB = Immediate8(NONE);
 	ICPU.ShiftedDB = ICPU.Registers.DB << 16;
 	ICPU.OpenBus = SrcBank = Immediate8(NONE);
-	ICPU.OpenBus = GetByte((SrcBank << 16) + ICPU.Registers.X.W);
-	SetByte(ICPU.OpenBus, ICPU.ShiftedDB + ICPU.Registers.Y.W);
+	Src = (SrcBank << 16) + ICPU.Registers.X.W;
+	Dst = ICPU.ShiftedDB + ICPU.Registers.Y.W;
+	NOT_SA1(Cycles = CPU.Cycles);
+	ICPU.OpenBus = GetByte(Src);
+	SetByte(ICPU.OpenBus, Dst);
 	ICPU.Registers.XL--;
 	ICPU.Registers.YL--;
 	ICPU.Registers.A.W--;
+	NOT_SA1(MoveBlockAhead(Src, Dst, -1, true, CPU.Cycles - Cycles));
 
 	if (ICPU.Registers.A.W != 0xffff)
 		ICPU.Registers.PCw -= 3;
@@ -3094,15 +3229,20 @@ static void Op44X1()
 
 static void Op44X0()
 {
-	uint32_t SrcBank;
+	uint32_t SrcBank, Src, Dst;
+	NOT_SA1(int32_t Cycles);
 	ICPU.Registers.DB = Immediate8(NONE);
 	ICPU.ShiftedDB = ICPU.Registers.DB << 16;
 	ICPU.OpenBus = SrcBank = Immediate8(NONE);
-	ICPU.OpenBus = GetByte((SrcBank << 16) + ICPU.Registers.X.W);
-	SetByte(ICPU.OpenBus, ICPU.ShiftedDB + ICPU.Registers.Y.W);
+	Src = (SrcBank << 16) + ICPU.Registers.X.W;
+	Dst = ICPU.ShiftedDB + ICPU.Registers.Y.W;
+	NOT_SA1(Cycles = CPU.Cycles);
+	ICPU.OpenBus = GetByte(Src);
+	SetByte(ICPU.OpenBus, Dst);
 	ICPU.Registers.X.W--;
 	ICPU.Registers.Y.W--;
 	ICPU.Registers.A.W--;
+	NOT_SA1(MoveBlockAhead(Src, Dst, -1, false, CPU.Cycles - Cycles));
 
 	if (ICPU.Registers.A.W != 0xffff)
 		ICPU.Registers.PCw -= 3;
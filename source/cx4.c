@@ -3,21 +3,43 @@
 #include "memmap.h"
 #include "ppu.h"
 
-static int16_t CX4WFXVal;
-static int16_t CX4WFYVal;
-static int16_t CX4WFZVal;
-static int16_t CX4WFX2Val;
-static int16_t CX4WFY2Val;
-static int16_t CX4WFDist;
-static int16_t CX4WFScale;
-static int16_t CX41FXVal;
-static int16_t CX41FYVal;
-static int16_t CX41FAngleRes;
-static int16_t CX41FDist;
-static int16_t CX41FDistVal;
-static int32_t tanval;
-static int32_t cx4x,  cx4y,  cx4z;
-static int32_t cx4x2, cx4y2, cx4z2;
+#ifdef MULTI_INSTANCE
+	#define CX4WFXVal     (*CX4WFXValPtr)
+	#define CX4WFYVal     (*CX4WFYValPtr)
+	#define CX4WFZVal     (*CX4WFZValPtr)
+	#define CX4WFX2Val    (*CX4WFX2ValPtr)
+	#define CX4WFY2Val    (*CX4WFY2ValPtr)
+	#define CX4WFDist     (*CX4WFDistPtr)
+	#define CX4WFScale    (*CX4WFScalePtr)
+	#define CX41FXVal     (*CX41FXValPtr)
+	#define CX41FYVal     (*CX41FYValPtr)
+	#define CX41FAngleRes (*CX41FAngleResPtr)
+	#define CX41FDist     (*CX41FDistPtr)
+	#define CX41FDistVal  (*CX41FDistValPtr)
+	#define tanval        (*tanvalPtr)
+	#define cx4x          (*cx4xPtr)
+	#define cx4y          (*cx4yPtr)
+	#define cx4z          (*cx4zPtr)
+	#define cx4x2         (*cx4x2Ptr)
+	#define cx4y2         (*cx4y2Ptr)
+	#define cx4z2         (*cx4z2Ptr)
+#endif
+
+STATIC_INSTANCE int16_t CX4WFXVal;
+STATIC_INSTANCE int16_t CX4WFYVal;
+STATIC_INSTANCE int16_t CX4WFZVal;
+STATIC_INSTANCE int16_t CX4WFX2Val;
+STATIC_INSTANCE int16_t CX4WFY2Val;
+STATIC_INSTANCE int16_t CX4WFDist;
+STATIC_INSTANCE int16_t CX4WFScale;
+STATIC_INSTANCE int16_t CX41FXVal;
+STATIC_INSTANCE int16_t CX41FYVal;
+STATIC_INSTANCE int16_t CX41FAngleRes;
+STATIC_INSTANCE int16_t CX41FDist;
+STATIC_INSTANCE int16_t CX41FDistVal;
+STATIC_INSTANCE int32_t tanval;
+STATIC_INSTANCE int32_t cx4x,  cx4y,  cx4z;
+STATIC_INSTANCE int32_t cx4x2, cx4y2, cx4z2;
 
 #define SIN_TO_COS_ANGLE(angle) \
 	((angle + 0x7f) & 0x1ff)
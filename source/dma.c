@@ -3,6 +3,7 @@
 #include "ppu.h"
 #include "dma.h"
 #include "apu.h"
+#include "fxemu.h"
 #include "sa1.h"
 #include "sdd1.h"
 #include "spc7110.h"
@@ -10,11 +11,111 @@
 
 #define AddCycles(cycles) CPU.Cycles += cycles
 
-static uint8_t sdd1_decode_buffer[0x10000];
+static THREAD_LOCAL uint8_t sdd1_decode_buffer[0x10000];
 
 extern int32_t  HDMA_ModeByteCounts[8];
-extern uint8_t* HDMAMemPointers[8];
-extern uint8_t* HDMABasePointers[8];
+
+/* The destinations below take most of the DMA time, so they get their own loops. They leave the PPU and memory exactly
+ * as the byte by byte writes would. p is the source offset and wraps within the bank, like the A-bus address. */
+
+/* Writes to OAMDATA that leave the low table unchanged, as when a game sends the same sprites again every frame, only
+ * move the OAM address along. Anything else goes through REGISTER_2104. */
+static void DMAToOAM(const uint8_t* base, uint16_t p, int32_t inc, int32_t count)
+{
+	while (count > 0)
+	{
+		if (inc == 1 && count >= 16 && p <= 0x10000 - 16 && PPU.OAMAddr <= 0x100 - 8 && !(PPU.OAMFlip & 1) && !PPU.OAMPriorityRotation && !memcmp(base + p, PPU.OAMData + (PPU.OAMAddr << 1), 16))
+		{
+			PPU.OAMWriteRegister = base[p + 14] | (base[p + 15] << 8);
+			PPU.OAMAddr         += 8;
+			p                   += 16;
+			count               -= 16;
+			continue;
+		}
+
+		REGISTER_2104(base[p]);
+		p += inc;
+		count--;
+	}
+}
+
+/* Mode 1 writes to VMDATA, with the address moving by one word after the high byte, fill consecutive VRAM bytes. They
+ * are copied in runs, clearing the cached tiles of each run at once. */
+static void DMAToVRAM(const uint8_t* base, uint16_t p, int32_t inc, int32_t count)
+{
+	int32_t words = count >> 1;
+
+	while (words > 0)
+	{
+		uint32_t address = (PPU.VMA.Address << 1) & 0xffff;
+		int32_t  run     = words;
+
+		if (run > (int32_t) (0x10000 - address) >> 1)
+			run = (0x10000 - address) >> 1;
+
+		if (inc > 0 && run > (0x10000 - p) >> 1)
+			run = (0x10000 - p) >> 1;
+
+		if (run == 0) /* The source wraps between the two bytes */
+		{
+			REGISTER_2118_linear(base[p]);
+			p += inc;
+			ICPU.OpenBus = base[p];
+			REGISTER_2119_linear(ICPU.OpenBus);
+			p += inc;
+			words--;
+			continue;
+		}
+
+		if (inc > 0)
+			memcpy(Memory.VRAM + address, base + p, run << 1);
+		else
+			memset(Memory.VRAM + address, base[p], run << 1);
+
+		memset(IPPU.TileCached[TILE_2BIT] + (address >> 4), 0, ((address + (run << 1) - 1) >> 4) - (address >> 4) + 1);
+		memset(IPPU.TileCached[TILE_4BIT] + (address >> 5), 0, ((address + (run << 1) - 1) >> 5) - (address >> 5) + 1);
+		memset(IPPU.TileCached[TILE_8BIT] + (address >> 6), 0, ((address + (run << 1) - 1) >> 6) - (address >> 6) + 1);
+		ICPU.OpenBus       = base[inc > 0 ? p + (run << 1) - 1 : p];
+		PPU.VMA.Address   += run;
+		p                 += inc * (run << 1);
+		words             -= run;
+	}
+
+	if (count & 1)
+		REGISTER_2118_linear(base[p]);
+}
+
+/* The source can be the low RAM mirror, so runs that overlap the destination are still copied a byte at a time */
+static void DMAToWRAM(const uint8_t* base, uint16_t p, int32_t inc, int32_t count)
+{
+	while (count > 0)
+	{
+		uint8_t*       to   = Memory.RAM + PPU.WRAM;
+		const uint8_t* from = base + p;
+		int32_t        run  = count;
+		int32_t        i;
+
+		if (run > (int32_t) (0x20000 - PPU.WRAM))
+			run = 0x20000 - PPU.WRAM;
+
+		if (inc > 0 && run > 0x10000 - p)
+			run = 0x10000 - p;
+		else if (inc < 0 && run > p + 1)
+			run = p + 1;
+
+		if (inc == 0)
+			memset(to, *from, run);
+		else if (inc > 0 && (from >= to + run || from + run <= to))
+			memcpy(to, from, run);
+		else
+			for (i = 0; i < run; i++)
+				to[i] = from[inc * i];
+
+		PPU.WRAM = (PPU.WRAM + run) & 0x1ffff;
+		p       += inc * run;
+		count   -= run;
+	}
+}
 
 void DoDMA(uint8_t Channel)
 {
@@ -30,6 +131,11 @@ void DoDMA(uint8_t Channel)
 	if (Channel > 7 || CPU.InDMA)
 		return;
 
+	if (Settings.Chip == SA_1)
+		SA1CatchUp();
+	else if (Settings.Chip == GSU)
+		SuperFXCatchUp();
+
 	CPU.InDMA = true;
 	d         = DMA + Channel;
 	count     = d->TransferBytes;
@@ -38,6 +144,8 @@ void DoDMA(uint8_t Channel)
 	if (count == 0)
 		count = 0x10000;
 
+	PERF_COUNT(PERF_DMA_BYTES, count);
+
 	inc = d->AAddressFixed ? 0 : (!d->AAddressDecrement ? 1 : -1);
 
 	if ((d->ABank == 0x7E || d->ABank == 0x7F) && d->BAddress == 0x80 && !d->ReverseTransfer)
@@ -73,10 +181,16 @@ void DoDMA(uint8_t Channel)
 			if (in_ptr)
 			{
 				in_ptr += d->AAddress;
-				SDD1_decompress(sdd1_decode_buffer, in_ptr, d->TransferBytes);
+				in_sdd1_dma = SDD1_GetDecompressed(in_ptr, d->TransferBytes);
 			}
 
-			in_sdd1_dma = sdd1_decode_buffer;
+			if (!in_sdd1_dma)
+			{
+				if (in_ptr)
+					SDD1_decompress(sdd1_decode_buffer, in_ptr, d->TransferBytes);
+
+				in_sdd1_dma = sdd1_decode_buffer;
+			}
 		}
 
 		Memory.FillRAM[0x4801] = 0;
@@ -255,13 +369,7 @@ void DoDMA(uint8_t Channel)
 			switch (d->BAddress)
 			{
 				case 0x04: /* OAMDATA */
-					do
-					{
-						Work = base[p];
-						REGISTER_2104(Work);
-						p += inc;
-					} while (--count > 0);
-
+					DMAToOAM(base, p, inc, count);
 					break;
 				case 0x18: /* VMDATAL */
 					IPPU.FirstVRAMRead = true;
@@ -319,13 +427,7 @@ void DoDMA(uint8_t Channel)
 
 					break;
 				case 0x80: /* WMDATA */
-					do
-					{
-						Work = base[p];
-						REGISTER_2180(Work);
-						p += inc;
-					} while (--count > 0);
-
+					DMAToWRAM(base, p, inc, count);
 					break;
 				default:
 					do
@@ -345,7 +447,9 @@ void DoDMA(uint8_t Channel)
 				/* Write to V-RAM */
 				IPPU.FirstVRAMRead = true;
 
-				if (!PPU.VMA.FullGraphicCount)
+				if (!PPU.VMA.FullGraphicCount && PPU.VMA.High && PPU.VMA.Increment == 1 && inc >= 0)
+					DMAToVRAM(base, p, inc, count);
+				else if (!PPU.VMA.FullGraphicCount)
 				{
 					while (count > 1)
 					{
@@ -749,6 +853,8 @@ uint8_t DoHDMA(uint8_t byte)
 				break;
 		}
 
+		PERF_COUNT(PERF_HDMA_BYTES, HDMA_ModeByteCounts[p->TransferMode]);
+
 		if (!p->HDMAIndirectAddressing)
 			p->Address += HDMA_ModeByteCounts[p->TransferMode];
 
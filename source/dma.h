@@ -1,6 +1,15 @@
 #ifndef CHIMERASNES_DMA_H_
 #define CHIMERASNES_DMA_H_
 
+#ifdef MULTI_INSTANCE
+	#define HDMAMemPointers  (*HDMAMemPointersPtr)
+	#define HDMABasePointers (*HDMABasePointersPtr)
+#endif
+
+extern INSTANCE uint8_t* HDMAMemPointers[8];
+extern INSTANCE uint8_t* HDMABasePointers[8];
+
+
 void    ResetDMA();
 uint8_t DoHDMA(uint8_t byte);
 void    StartHDMA();
@@ -2,8 +2,8 @@
 #include "dsp.h"
 #include "memmap.h"
 
-uint8_t (*GetDSP)(uint16_t) = NULL;
-void (*SetDSP)(uint8_t, uint16_t) = NULL;
+INSTANCE uint8_t (*GetDSP)(uint16_t);
+INSTANCE void (*SetDSP)(uint8_t, uint16_t);
 
 void ResetDSP()
 {
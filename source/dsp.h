@@ -389,11 +389,21 @@ typedef struct
 	uint32_t out_index;
 } SDSP4;
 
-extern SDSP0 DSP0;
-extern SDSP1 DSP1;
-extern SDSP2 DSP2;
-extern SDSP3 DSP3;
-extern SDSP4 DSP4;
+#ifdef MULTI_INSTANCE
+	#define DSP0   (*DSP0Ptr)
+	#define DSP1   (*DSP1Ptr)
+	#define DSP2   (*DSP2Ptr)
+	#define DSP3   (*DSP3Ptr)
+	#define DSP4   (*DSP4Ptr)
+	#define GetDSP (*GetDSPPtr)
+	#define SetDSP (*SetDSPPtr)
+#endif
+
+extern INSTANCE SDSP0 DSP0;
+extern INSTANCE SDSP1 DSP1;
+extern INSTANCE SDSP2 DSP2;
+extern INSTANCE SDSP3 DSP3;
+extern INSTANCE SDSP4 DSP4;
 
 void    ResetDSP();
 uint8_t DSP1GetByte(uint16_t);
@@ -406,6 +416,6 @@ void    DSP3_Reset();
 uint8_t DSP4GetByte(uint16_t);
 void    DSP4SetByte(uint8_t, uint16_t);
 
-extern uint8_t (*GetDSP)(uint16_t);
-extern void    (*SetDSP)(uint8_t, uint16_t);
+extern INSTANCE uint8_t (*GetDSP)(uint16_t);
+extern INSTANCE void    (*SetDSP)(uint8_t, uint16_t);
 #endif
@@ -2,7 +2,11 @@
 #include "dsp.h"
 #include "memmap.h"
 
-static void (*SetDSP3)();
+#ifdef MULTI_INSTANCE
+	#define SetDSP3 (*SetDSP3Ptr)
+#endif
+
+STATIC_INSTANCE void (*SetDSP3)();
 
 static const uint16_t DSP3_DataROM[1024] =
 {
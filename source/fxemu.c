@@ -6,24 +6,28 @@
 #include "fxinst.h"
 #include "ppu.h"
 
-/* The FX chip emulator's internal variables */
-extern FXRegs_s FXRegs; /* This will be initialized when loading a ROM */
-extern FXInfo_s SuperFX;
+#define FX_SLICE_LINES 16 /* Longest the GSU can lag behind when it runs in slices */
 
 extern void ClearIRQSource(uint32_t source);
 extern void SetIRQSource(uint32_t source);
 
+static void fx_flushRegisterSpace();
+static void SuperFXGo();
+
 uint8_t GetSuperFX(uint16_t address)
 {
-	uint8_t byte = Memory.FillRAM[address];
-
-	if (address == 0x3030)
-		CPU.WaitPC = CPU.PCAtOpcodeStart;
+	uint8_t byte;
+	SuperFXCatchUp();
+	fx_flushRegisterSpace();
+	byte = Memory.FillRAM[address];
 
 	if (address == 0x3031)
 	{
 		ClearIRQSource(GSU_IRQ_SOURCE);
 		Memory.FillRAM[0x3031] = byte & 0x7f;
+
+		if (FXRegs.bRegistersLive)
+			CF(IRQ);
 	}
 
 	return byte;
@@ -36,6 +40,10 @@ void SetSuperFX(uint8_t Byte, uint16_t Address)
 	if (Settings.Chip != GSU)
 		return;
 
+	/* The next run reads the register space again */
+	SuperFXCatchUp();
+	fx_flushRegisterSpace();
+	FXRegs.bRegistersLive = false;
 	old_fill_ram = Memory.FillRAM[Address];
 	Memory.FillRAM[Address] = Byte;
 
@@ -48,7 +56,7 @@ void SetSuperFX(uint8_t Byte, uint16_t Address)
 			Memory.FillRAM[Address] = Byte;
 
 			if (Byte & FLG_G) /* Go flag has been changed */
-				SuperFXExec();
+				SuperFXGo();
 			else
 				FxFlushCache();
 
@@ -65,32 +73,83 @@ void SetSuperFX(uint8_t Byte, uint16_t Address)
 			break;
 		case 0x301f:
 			Memory.FillRAM[0x3000 + GSU_SFR] |= FLG_G;
-			SuperFXExec();
+			SuperFXGo();
 			break;
 		default:
 			break;
 	}
 }
 
-void SuperFXExec()
+static INLINE uint32_t fx_status()
+{
+	if (FXRegs.bRegistersLive)
+		return FXRegs.vStatusReg;
+
+	return Memory.FillRAM[0x3000 + GSU_SFR] | (Memory.FillRAM[0x3000 + GSU_SFR + 1] << 8);
+}
+
+/* Runs the GSU for the given number of scanlines */
+static void SuperFXRun(uint32_t lines)
 {
-	if ((Memory.FillRAM[0x3000 + GSU_SFR] & FLG_G) && (Memory.FillRAM[0x3000 + GSU_SCMR] & 0x18) == 0x18)
+	if ((fx_status() & FLG_G) && (Memory.FillRAM[0x3000 + GSU_SCMR] & 0x18) == 0x18)
 	{
-		uint16_t GSUStatus;
-		FxEmulate((Memory.FillRAM[0x3000 + GSU_CLSR] & 1) ? Settings.SuperFXSpeedPerLine * 2 : Settings.SuperFXSpeedPerLine);
-		GSUStatus = Memory.FillRAM[0x3000 + GSU_SFR] | (Memory.FillRAM[0x3000 + GSU_SFR + 1] << 8);
+		FxEmulate(lines * ((Memory.FillRAM[0x3000 + GSU_CLSR] & 1) ? Settings.SuperFXSpeedPerLine * 2 : Settings.SuperFXSpeedPerLine));
 
-		if ((GSUStatus & (FLG_G | FLG_IRQ)) == FLG_IRQ)
+		if ((fx_status() & (FLG_G | FLG_IRQ)) == FLG_IRQ)
 			SetIRQSource(GSU_IRQ_SOURCE);
 	}
 }
 
+/* Called at the end of every scanline. In slices, the GSU only runs once it is FX_SLICE_LINES behind, or before the
+ * SNES CPU touches its registers or RAM. */
+void SuperFXExec()
+{
+	if (!Settings.SuperFXSlices)
+		SuperFXRun(1);
+	else if (++FXRegs.vCatchUpLines >= FX_SLICE_LINES)
+		SuperFXCatchUp();
+}
+
+/* The SNES CPU has just started the GSU */
+static void SuperFXGo()
+{
+	if (Settings.SuperFXSlices)
+		FXRegs.vCatchUpLines++;
+	else
+		SuperFXRun(1);
+}
+
+void SuperFXCatchUp()
+{
+	uint32_t lines = FXRegs.vCatchUpLines;
+
+	if (lines == 0)
+		return;
+
+	FXRegs.vCatchUpLines = 0;
+	SuperFXRun(lines);
+}
+
+/* Called at the end of every frame, so that the register space is up to date for savestates */
+void SuperFXSync()
+{
+	SuperFXCatchUp();
+	fx_flushRegisterSpace();
+	FXRegs.bRegistersLive = false;
+}
+
 void FxFlushCache()
 {
 	FXRegs.vCacheBaseReg = 0;
 	FXRegs.bCacheActive = false;
 }
 
+void FxInvalidateBlocks()
+{
+	if (FXBlocks)
+		memset(FXBlocks, 0, FX_BLOCK_COUNT * sizeof(SFXBlock));
+}
+
 void fx_updateRamBank(uint8_t Byte)
 {
 	/* Update BankReg and Bank pointer */
@@ -104,6 +163,14 @@ static INLINE void fx_readRegisterSpaceForCheck()
 	R15 |= ((uint32_t) FXRegs.pvRegisters[31]) << 8;
 }
 
+static INLINE void fx_selectPlot()
+{
+	fx_OpcodeTable[0x04c] = fx_PlotTable[FXRegs.vMode];
+	fx_OpcodeTable[0x14c] = fx_PlotTable[FXRegs.vMode + 5];
+	fx_OpcodeTable[0x24c] = fx_PlotTable[FXRegs.vMode];
+	fx_OpcodeTable[0x34c] = fx_PlotTable[FXRegs.vMode + 5];
+}
+
 static void fx_readRegisterSpaceForUse()
 {
 	static uint32_t avHeight[] = {128, 160, 192, 256};
@@ -156,10 +223,7 @@ static void fx_readRegisterSpaceForUse()
 	if (FXRegs.pvScreenBase + FXRegs.vScreenSize > FXRegs.pvRam + (FXRegs.nRamBanks * 65536))
 		FXRegs.pvScreenBase = FXRegs.pvRam + (FXRegs.nRamBanks * 65536) - FXRegs.vScreenSize;
 
-	fx_OpcodeTable[0x04c] = fx_PlotTable[FXRegs.vMode];
-	fx_OpcodeTable[0x14c] = fx_PlotTable[FXRegs.vMode + 5];
-	fx_OpcodeTable[0x24c] = fx_PlotTable[FXRegs.vMode];
-	fx_OpcodeTable[0x34c] = fx_PlotTable[FXRegs.vMode + 5];
+	fx_selectPlot();
 
 	if (FXRegs.vMode != FXRegs.vPrevMode || FXRegs.vPrevScreenHeight != FXRegs.vScreenHeight || FXRegs.vSCBRDirty)
 		fx_computeScreenPointers();
@@ -263,6 +327,17 @@ static void fx_writeRegisterSpaceAfterUse()
 	FXRegs.pvRegisters[GSU_CBR + 1] = (uint8_t) (FXRegs.vCacheBaseReg >> 8);
 }
 
+/* Brings the register space up to date with the registers kept live in FXRegs by the last run in slices */
+static void fx_flushRegisterSpace()
+{
+	if (!FXRegs.bRegistersDirty)
+		return;
+
+	fx_writeRegisterSpaceAfterCheck();
+	fx_writeRegisterSpaceAfterUse();
+	FXRegs.bRegistersDirty = false;
+}
+
 void FxReset(FXInfo_s* psFXInfo) /* Reset the FxChip */
 {
 	int32_t i;
@@ -311,8 +386,14 @@ void FxReset(FXInfo_s* psFXInfo) /* Reset the FxChip */
 	}
 
 	FXRegs.vPipe = 0x01; /* Start with a nop in the pipe */
+
+	if (!FXBlocks) /* Only SuperFX games use the block cache. Without it, every instruction is decoded as it runs. */
+		FXBlocks = (SFXBlock*) calloc(FX_BLOCK_COUNT, sizeof(SFXBlock));
+
+	FxInvalidateBlocks();
 	fx_readRegisterSpaceForCheck();
 	fx_readRegisterSpaceForUse();
+	FXRegs.vBlockMode = FXRegs.vMode;
 }
 
 static bool fx_checkStartAddress()
@@ -333,20 +414,39 @@ static bool fx_checkStartAddress()
 
 void FxEmulate(uint32_t nInstructions) /* Execute until the next stop instruction */
 {
-	fx_readRegisterSpaceForCheck(); /* Read registers and initialize GSU session */
+	if (!FXRegs.bRegistersLive)
+		fx_readRegisterSpaceForCheck(); /* Read registers and initialize GSU session */
 
 	if (!fx_checkStartAddress()) /* Check if the start address is valid */
 	{
 		CF(G);
-		fx_writeRegisterSpaceAfterCheck();
+
+		if (FXRegs.bRegistersLive)
+			FXRegs.bRegistersDirty = true;
+		else
+			fx_writeRegisterSpaceAfterCheck();
+
 		return;
 	}
 
-	fx_readRegisterSpaceForUse();
+	if (!FXRegs.bRegistersLive)
+		fx_readRegisterSpaceForUse();
+	else
+		fx_selectPlot(); /* The table is shared by every context */
 
 	/* Execute GSU session */
 	CF(IRQ);
+	PERF_START(PERF_FX_EMULATE);
 	fx_run(nInstructions);
+	PERF_STOP(PERF_FX_EMULATE);
+
+	/* In slices, the registers stay in FXRegs until the SNES CPU needs them */
+	if (Settings.SuperFXSlices)
+	{
+		FXRegs.bRegistersLive  = true;
+		FXRegs.bRegistersDirty = true;
+		return;
+	}
 
 	/* Store GSU registers */
 	fx_writeRegisterSpaceAfterCheck();
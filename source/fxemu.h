@@ -13,14 +13,21 @@ typedef struct
 	uint8_t* pvRegisters; /* 768 bytes located in the memory at address 0x3000 */
 } FXInfo_s;
 
-extern FXInfo_s SuperFX;
+#ifdef MULTI_INSTANCE
+	#define SuperFX (*SuperFXPtr)
+#endif
+
+extern INSTANCE FXInfo_s SuperFX;
 
 uint8_t GetSuperFX(uint16_t address);
 void    SetSuperFX(uint8_t Byte, uint16_t Address);
 void    SuperFXExec();
+void    SuperFXCatchUp();                  /* Runs the GSU for the scanlines it is behind by when it runs in slices */
+void    SuperFXSync();                     /* Also brings the register space up to date */
 void    FxReset(FXInfo_s* psFXInfo);       /* Reset the FxChip */
 void    FxEmulate(uint32_t nInstructions); /* Execute until the next stop instruction */
 void    FxFlushCache();                    /* Write access to the cache - Called when the G flag in SFR is set to zero */
+void    FxInvalidateBlocks();              /* Must be called whenever the contents of ROM change */
 void    fx_dirtySCBR();                    /* SCBR write seen.  We need to update our cached screen pointers */
 void    fx_updateRamBank(uint8_t Byte);    /* Update RamBankReg and RAM Bank pointer */
 void    fx_computeScreenPointers();
@@ -356,6 +356,7 @@ static void fx_with_r15()
 
 /* 30-3b - stw (rn) - store word */
 #define FX_STW(reg)                                     \
+	FLUSHPIXELS;                                        \
 	FXRegs.vLastRamAdr = FXRegs.avReg[reg];             \
 	RAM(FXRegs.avReg[reg]) = (uint8_t) SREG;            \
 	RAM(FXRegs.avReg[reg] ^ 1) = (uint8_t) (SREG >> 8); \
@@ -424,6 +425,7 @@ static void fx_stw_r11()
 
 /* 30-3b(ALT1) - stb (rn) - store byte */
 #define FX_STB(reg)                          \
+	FLUSHPIXELS;                             \
 	FXRegs.vLastRamAdr = FXRegs.avReg[reg];  \
 	RAM(FXRegs.avReg[reg]) = (uint8_t) SREG; \
 	CLRFLAGS;                                \
@@ -526,6 +528,7 @@ static void fx_alt3() /* 3f - alt3 - set alt3 mode */
 /* 40-4b - ldw (rn) - load word from RAM */
 #define FX_LDW(reg)                                    \
 	uint32_t v;                                        \
+	FLUSHPIXELS;                                       \
 	FXRegs.vLastRamAdr = FXRegs.avReg[reg];            \
 	v = (uint32_t) RAM(FXRegs.avReg[reg]);             \
 	v |= ((uint32_t) RAM(FXRegs.avReg[reg] ^ 1)) << 8; \
@@ -597,6 +600,7 @@ static void fx_ldw_r11()
 /* 40-4b(ALT1) - ldb (rn) - load byte */
 #define FX_LDB(reg)                         \
 	uint32_t v;                             \
+	FLUSHPIXELS;                            \
 	FXRegs.vLastRamAdr = FXRegs.avReg[reg]; \
 	v = (uint32_t) RAM(FXRegs.avReg[reg]);  \
 	R15++;                                  \
@@ -664,12 +668,55 @@ static void fx_ldb_r11()
 	FX_LDB(11);
 }
 
+/* The GSU does not write each plotted pixel to RAM. It keeps the pixels of the 8 pixel wide row of a character that it
+ * last plotted to, one byte of colour each, and writes the bitplanes of that row once it plots outside it, reads RAM or a
+ * pixel, changes the plot mode or stops. Only the pixels that were plotted are written. */
+void fx_flushPixelCache()
+{
+	uint64_t x = FXRegs.vPixelCache;
+	uint64_t t;
+	uint8_t* a = FXRegs.pvPixelCache;
+	uint8_t mask = FXRegs.vPixelCacheMask;
+	uint32_t p;
+
+	/* Transpose the 8x8 bit matrix, so that byte p holds bitplane p of the row */
+	t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;
+	x ^= t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;
+	x ^= t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;
+	x ^= t ^ (t << 28);
+
+	for (p = 0; p < FXRegs.vPixelCachePlanes; p++)
+	{
+		uint8_t* b = a + ((p >> 1) << 4) + (p & 1);
+		*b = (*b & ~mask) | ((uint8_t) (x >> (p << 3)) & mask);
+	}
+
+	FXRegs.vPixelCacheMask = 0;
+}
+
+static INLINE void fx_cachePixel(uint32_t x, uint32_t y, uint8_t c, uint8_t planes)
+{
+	uint8_t* a = FXRegs.apvScreen[y >> 3] + FXRegs.x[x >> 3] + ((y & 7) << 1);
+	uint32_t shift = (7 - (x & 7)) << 3;
+
+	if (a != FXRegs.pvPixelCache || planes != FXRegs.vPixelCachePlanes)
+	{
+		FLUSHPIXELS;
+		FXRegs.pvPixelCache = a;
+		FXRegs.vPixelCachePlanes = planes;
+	}
+
+	FXRegs.vPixelCache = (FXRegs.vPixelCache & ~((uint64_t) 0xff << shift)) | ((uint64_t) c << shift);
+	FXRegs.vPixelCacheMask |= 1 << (shift >> 3);
+}
+
 static void fx_plot_2bit() /* 4c - plot - plot pixel with R1,R2 as x,y and the color register as the color */
 {
 	uint32_t x = USEX8(R1);
 	uint32_t y = USEX8(R2);
-	uint8_t* a;
-	uint8_t v, c;
+	uint8_t c;
 	R15++;
 	CLRFLAGS;
 	R1++;
@@ -682,18 +729,7 @@ static void fx_plot_2bit() /* 4c - plot - plot pixel with R1,R2 as x,y and the c
 	else
 		c = (uint8_t) FXRegs.vColorReg;
 
-	a = FXRegs.apvScreen[y >> 3] + FXRegs.x[x >> 3] + ((y & 7) << 1);
-	v = 128 >> (x & 7);
-
-	if (c & 0x01)
-		a[0] |= v;
-	else
-		a[0] &= ~v;
-
-	if (c & 0x02)
-		a[1] |= v;
-	else
-		a[1] &= ~v;
+	fx_cachePixel(x, y, c, 2);
 }
 
 static void fx_rpix_2bit() /* 2c(ALT1) - rpix - read color of the pixel with R1,R2 as x,y */
@@ -704,6 +740,7 @@ static void fx_rpix_2bit() /* 2c(ALT1) - rpix - read color of the pixel with R1,
 	uint8_t v;
 	R15++;
 	CLRFLAGS;
+	FLUSHPIXELS;
 	a = FXRegs.apvScreen[y >> 3] + FXRegs.x[x >> 3] + ((y & 7) << 1);
 	v = 128 >> (x & 7);
 	DREG = 0;
@@ -716,8 +753,7 @@ static void fx_plot_4bit() /* 4c - plot - plot pixel with R1,R2 as x,y and the c
 {
 	uint32_t x = USEX8(R1);
 	uint32_t y = USEX8(R2);
-	uint8_t* a;
-	uint8_t v, c;
+	uint8_t c;
 	R15++;
 	CLRFLAGS;
 	R1++;
@@ -730,28 +766,7 @@ static void fx_plot_4bit() /* 4c - plot - plot pixel with R1,R2 as x,y and the c
 	else
 		c = (uint8_t) FXRegs.vColorReg;
 
-	a = FXRegs.apvScreen[y >> 3] + FXRegs.x[x >> 3] + ((y & 7) << 1);
-	v = 128 >> (x & 7);
-
-	if (c & 0x01)
-		a[0x00] |= v;
-	else
-		a[0x00] &= ~v;
-
-	if (c & 0x02)
-		a[0x01] |= v;
-	else
-		a[0x01] &= ~v;
-
-	if (c & 0x04)
-		a[0x10] |= v;
-	else
-		a[0x10] &= ~v;
-
-	if (c & 0x08)
-		a[0x11] |= v;
-	else
-		a[0x11] &= ~v;
+	fx_cachePixel(x, y, c, 4);
 }
 
 static void fx_rpix_4bit() /* 4c(ALT1) - rpix - read color of the pixel with R1,R2 as x,y */
@@ -762,6 +777,7 @@ static void fx_rpix_4bit() /* 4c(ALT1) - rpix - read color of the pixel with R1,
 	uint8_t v;
 	R15++;
 	CLRFLAGS;
+	FLUSHPIXELS;
 	a = FXRegs.apvScreen[y >> 3] + FXRegs.x[x >> 3] + ((y & 7) << 1);
 	v = 128 >> (x & 7);
 	DREG = 0;
@@ -776,8 +792,7 @@ static void fx_plot_8bit() /* 8c - plot - plot pixel with R1,R2 as x,y and the c
 {
 	uint32_t x = USEX8(R1);
 	uint32_t y = USEX8(R2);
-	uint8_t* a;
-	uint8_t v, c;
+	uint8_t c;
 	R15++;
 	CLRFLAGS;
 	R1++;
@@ -791,48 +806,7 @@ static void fx_plot_8bit() /* 8c - plot - plot pixel with R1,R2 as x,y and the c
 	else if (!(FXRegs.vPlotOptionReg & 0x01) && !c)
 		return;
 
-	a = FXRegs.apvScreen[y >> 3] + FXRegs.x[x >> 3] + ((y & 7) << 1);
-	v = 128 >> (x & 7);
-
-	if (c & 0x01)
-		a[0x00] |= v;
-	else
-		a[0x00] &= ~v;
-
-	if (c & 0x02)
-		a[0x01] |= v;
-	else
-		a[0x01] &= ~v;
-
-	if (c & 0x04)
-		a[0x10] |= v;
-	else
-		a[0x10] &= ~v;
-
-	if (c & 0x08)
-		a[0x11] |= v;
-	else
-		a[0x11] &= ~v;
-
-	if (c & 0x10)
-		a[0x20] |= v;
-	else
-		a[0x20] &= ~v;
-
-	if (c & 0x20)
-		a[0x21] |= v;
-	else
-		a[0x21] &= ~v;
-
-	if (c & 0x40)
-		a[0x30] |= v;
-	else
-		a[0x30] &= ~v;
-
-	if (c & 0x80)
-		a[0x31] |= v;
-	else
-		a[0x31] &= ~v;
+	fx_cachePixel(x, y, c, 8);
 }
 
 static void fx_rpix_8bit() /* 4c(ALT1) - rpix - read color of the pixel with R1,R2 as x,y */
@@ -843,6 +817,7 @@ static void fx_rpix_8bit() /* 4c(ALT1) - rpix - read color of the pixel with R1,
 	uint8_t v;
 	R15++;
 	CLRFLAGS;
+	FLUSHPIXELS;
 	a = FXRegs.apvScreen[y >> 3] + FXRegs.x[x >> 3] + ((y & 7) << 1);
 	v = 128 >> (x & 7);
 	DREG = 0;
@@ -896,6 +871,7 @@ static void fx_color() /* 4e - color - copy source register to color register */
 
 static void fx_cmode() /* 4e(ALT1) - cmode - set plot option register */
 {
+	FLUSHPIXELS;
 	FXRegs.vPlotOptionReg = SREG;
 
 	if (FXRegs.vPlotOptionReg & 0x10)
@@ -2368,6 +2344,7 @@ static void fx_umult_i15()
 
 static void fx_sbk() /* 90 - sbk - store word to last accessed RAM address */
 {
+	FLUSHPIXELS;
 	RAM(FXRegs.vLastRamAdr) = (uint8_t) SREG;
 	RAM(FXRegs.vLastRamAdr ^ 1) = (uint8_t) (SREG >> 8);
 	CLRFLAGS;
@@ -2667,6 +2644,7 @@ static void fx_ibt_r15()
 	R15++;                                                              \
 	FETCHPIPE;                                                          \
 	R15++;                                                              \
+	FLUSHPIXELS;                                                        \
 	FXRegs.avReg[reg] = (uint32_t) RAM(FXRegs.vLastRamAdr);             \
 	FXRegs.avReg[reg] |= ((uint32_t) RAM(FXRegs.vLastRamAdr + 1)) << 8; \
 	CLRFLAGS
@@ -2759,6 +2737,7 @@ static void fx_lms_r15()
 	FXRegs.vLastRamAdr = ((uint32_t) PIPE) << 1;      \
 	R15++;                                            \
 	FETCHPIPE;                                        \
+	FLUSHPIXELS;                                      \
 	RAM(FXRegs.vLastRamAdr) = (uint8_t) v;            \
 	RAM(FXRegs.vLastRamAdr + 1) = (uint8_t) (v >> 8); \
 	CLRFLAGS;                                         \
@@ -3638,6 +3617,7 @@ static void fx_iwt_r15()
 	FXRegs.vLastRamAdr |= USEX8(PIPE) << 8;                       \
 	FETCHPIPE;                                                    \
 	R15++;                                                        \
+	FLUSHPIXELS;                                                  \
 	FXRegs.avReg[reg] = RAM(FXRegs.vLastRamAdr);                  \
 	FXRegs.avReg[reg] |= USEX8(RAM(FXRegs.vLastRamAdr ^ 1)) << 8; \
 	CLRFLAGS
@@ -3733,6 +3713,7 @@ static void fx_lm_r15()
 	R15++;                                            \
 	FXRegs.vLastRamAdr |= USEX8(PIPE) << 8;           \
 	FETCHPIPE;                                        \
+	FLUSHPIXELS;                                      \
 	RAM(FXRegs.vLastRamAdr) = (uint8_t) v;            \
 	RAM(FXRegs.vLastRamAdr ^ 1) = (uint8_t) (v >> 8); \
 	CLRFLAGS; \
@@ -3820,18 +3801,230 @@ static void fx_sm_r15()
 
 /* GSU executions functions */
 
+/* Jumps, branches and stop, all alternatives, and the prefixes that leave the flags set but could not be folded */
+static bool fx_endsBlock(uint8_t op, uint32_t flags)
+{
+	switch (op >> 4)
+	{
+		case 0x0:
+			return op == 0x00 || op >= 0x05;
+		case 0x1: /* to, unless it is move */
+		case 0xb: /* from, unless it is moves */
+			return !(flags & FLG_B);
+		case 0x2: /* with */
+			return true;
+		case 0x3:
+			return op >= 0x3c;
+		case 0x9:
+			return op >= 0x98 && op <= 0x9d;
+		default:
+			return false;
+	}
+}
+
+static uint32_t fx_opLength(uint8_t op)
+{
+	if (op >= 0x05 && op <= 0x0f) /* Branches */
+		return 2;
+
+	if (op >= 0xa0 && op <= 0xaf) /* ibt, lms and sms */
+		return 2;
+
+	if (op >= 0xf0) /* iwt, lm and sm */
+		return 3;
+
+	return 1;
+}
+
+/* The prefixes that only select the ALT mode or the registers of the next instruction can be done by the block
+ * instead of their handlers. Returns false for any other instruction. */
+static bool fx_foldPrefix(SFXBlockOp* op, uint8_t code, uint32_t* flags)
+{
+	if (fx_OpcodeTable[(*flags & 0x300) | code] != fx_OpcodeTable[code])
+		return false;
+
+	switch (code >> 4)
+	{
+		case 0x1: /* to */
+			if (*flags & FLG_B)
+				return false;
+
+			op->Dreg = code & 0xf;
+			return true;
+		case 0x2: /* with */
+			*flags |= FLG_B;
+			op->Sreg = op->Dreg = code & 0xf;
+			return true;
+		case 0x3:
+			if (code < 0x3d)
+				return false;
+
+			*flags = (*flags | ((code == 0x3e) ? FLG_ALT2 : (code == 0x3f) ? FLG_ALT1 | FLG_ALT2 : FLG_ALT1)) & ~FLG_B;
+			return true;
+		case 0xb: /* from */
+			if (*flags & FLG_B)
+				return false;
+
+			op->Sreg = code & 0xf;
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* The instruction after a branch or jump is already in the pipe and runs before the one it goes to */
+static void fx_decodeDelaySlot(SFXBlock* block, uint8_t branch, uint8_t opcode, uint32_t flags)
+{
+	if (branch == 0x3c || (branch >= 0x98 && branch <= 0x9d && !(flags & 0x300))) /* loop and jmp clear the flags */
+		flags = 0;
+	else if (branch < 0x05 || branch > 0x0f)
+		return;
+
+	/* Its operands would come from where the branch goes */
+	if (!fx_endsBlock(opcode, flags) && fx_opLength(opcode) == 1)
+		block->DelayOp = fx_OpcodeTable[(flags & 0x300) | opcode];
+}
+
+/* Code in ROM cannot change under the GSU, so the handlers of a straight run of instructions and the byte each one
+ * fetches into the pipe can be looked up once. Every instruction that does not end the run clears the ALT1, ALT2 and
+ * B flags, so the mode of the next one is known. The run stops before the end of the bank, as R15 wraps around
+ * there. */
+static SFXBlock* fx_decodeBlock(SFXBlock* block, uint8_t* code, uint32_t flags)
+{
+	uint32_t pc = USEX16(R15 - 1);
+	uint32_t done = 0;
+	block->Code = code;
+	block->Flags = (uint16_t) flags;
+	block->Count = 0;
+	block->DelayOp = NULL;
+
+	while (block->Count < FX_BLOCK_MAX_OPS)
+	{
+		SFXBlockOp* op = &block->Ops[block->Count];
+		uint32_t start = pc;
+		uint8_t opcode = 0;
+		op->Sreg = op->Dreg = -1;
+
+		for (; pc + 3 <= 0xffff; pc++)
+		{
+			opcode = FXRegs.pvPrgBank[pc];
+
+			if (pc - start == FX_BLOCK_MAX_PREFIXES || !fx_foldPrefix(op, opcode, &flags))
+				break;
+		}
+
+		if (pc + 3 > 0xffff)
+			break;
+
+		op->Prefixes = (uint8_t) (pc - start);
+		op->PrefixFlags = (uint16_t) flags;
+		op->Op = fx_OpcodeTable[(flags & 0x300) | opcode];
+		op->Pipe = FXRegs.pvPrgBank[pc + 1];
+		pc += fx_opLength(opcode);
+		op->NextR15 = (uint16_t) (pc + 1);
+		done += op->Prefixes + 1;
+		op->Done = (uint8_t) done;
+		block->Count++;
+
+		if (fx_endsBlock(opcode, flags))
+		{
+			fx_decodeDelaySlot(block, opcode, FXRegs.pvPrgBank[pc], flags);
+			break;
+		}
+
+		flags = 0;
+	}
+
+	return block;
+}
+
+/* Runs the block that starts with the instruction in the pipe, and returns the instructions it ran. Code in RAM is
+ * not cached, as the GSU and the SNES CPU can write to it. */
+static INLINE uint32_t fx_runBlock(uint32_t nInstructions)
+{
+	uint8_t* code = FXRegs.pvPrgBank + USEX16(R15 - 1);
+	uint32_t flags = SFR & FX_BLOCK_FLAGS;
+	uint32_t ran;
+	SFXBlock* block;
+	SFXBlockOp* op;
+	SFXBlockOp* last;
+
+	if (!FXBlocks || FXRegs.vPrgBankReg >= 0x60 || PIPE != *code) /* After a branch, the pipe holds the instruction after it */
+		return 0;
+
+	block = &FXBlocks[FX_BLOCK_HASH(code, flags)];
+
+	if (block->Code != code || block->Flags != flags)
+		fx_decodeBlock(block, code, flags);
+
+	if (!block->Count || block->Ops[block->Count - 1].Done > nInstructions)
+		return 0;
+
+	for (op = block->Ops, last = op + block->Count - 1; ; op++)
+	{
+		if (op->Prefixes)
+		{
+			SFR = (SFR & ~FX_BLOCK_FLAGS) | op->PrefixFlags;
+			R15 += op->Prefixes;
+
+			if (op->Sreg >= 0)
+				FXRegs.pvSreg = &FXRegs.avReg[op->Sreg];
+
+			if (op->Dreg >= 0)
+				FXRegs.pvDreg = &FXRegs.avReg[op->Dreg];
+		}
+
+		PIPE = op->Pipe;
+		(*op->Op)();
+
+		if (op == last || R15 != op->NextR15) /* Or one that wrote to R15 */
+			break;
+	}
+
+	ran = op->Done;
+
+	if (op == last && block->DelayOp && ran < nInstructions)
+	{
+		FETCHPIPE;
+		(*block->DelayOp)();
+		ran++;
+	}
+
+	PERF_COUNT(PERF_GSU_OPS, ran);
+	return ran;
+}
+
 void fx_run(uint32_t nInstructions)
 {
-	while (TF(G) && (nInstructions-- > 0))
+	if (FXRegs.vBlockMode != FXRegs.vMode) /* The blocks hold the PLOT and RPIX handlers of the previous mode */
 	{
+		FxInvalidateBlocks();
+		FXRegs.vBlockMode = FXRegs.vMode;
+	}
+
+	while (TF(G) && nInstructions > 0)
+	{
+		uint32_t vOpcode;
+		uint32_t ran = fx_runBlock(nInstructions);
+
+		if (ran)
+		{
+			nInstructions -= ran;
+			continue;
+		}
+
 		/* Execute instruction from the pipe, and fetch next byte to the pipe */
-		uint32_t vOpcode = (uint32_t) PIPE;
+		vOpcode = (uint32_t) PIPE;
 		FETCHPIPE;
 		(*fx_OpcodeTable[(FXRegs.vStatusReg & 0x300) | vOpcode])();
+		PERF_COUNT(PERF_GSU_OPS, 1);
+		nInstructions--;
 
 		if (vOpcode == 0) /* fx_stop opcode, all alternatives */
-			return;
+			break;
 	}
+
+	FLUSHPIXELS;
 }
 
 /* Special table for the different plot configurations */
@@ -119,9 +119,11 @@
 typedef struct
 {
 	uint8_t   bCacheActive;
+	bool      bRegistersLive  : 1;      /* FXRegs holds the registers, not the register space */
+	bool      bRegistersDirty : 1;      /* The GSU ran since the register space was last written */
+	int8_t    _FXRegs_s_PAD1  : 6;
 
 	/* FxChip registers */
-	int8_t    _FXRegs_s_PAD1 : 8;
 	uint8_t   vRomBuffer;               /* Current byte read by R14 */
 	uint8_t   vPipe;                    /* Instructionset pipe */
 	uint32_t  avReg[16];                /* 16 Generic registers */
@@ -134,6 +136,12 @@ typedef struct
 	uint32_t  vCacheBaseReg;            /* Cache base address register */
 	uint32_t  vLastRamAdr;              /* Last RAM address accessed */
 	uint32_t  vSCBRDirty;               /* if SCBR is written, our cached screen pointers need updating */
+	uint32_t  vCatchUpLines;            /* Scanlines the GSU is behind by when it runs in slices */
+	uint64_t  vPixelCache;              /* Colour of each pixel in the pixel cache, the leftmost one in the top byte */
+	uint8_t*  pvPixelCache;             /* Character row the pixel cache holds */
+	uint8_t   vPixelCacheMask;          /* Pixels of that row that were plotted */
+	uint8_t   vPixelCachePlanes;        /* Bitplanes of that row */
+	uint32_t  vBlockMode;               /* Colour depth the cached blocks picked their PLOT and RPIX handlers for */
 	uint32_t* pvDreg;                   /* Pointer to current destination register */
 	uint32_t* pvSreg;                   /* Pointer to current source register */
 
@@ -165,7 +173,11 @@ typedef struct
 	uint8_t*  apvRomBank[256];          /* Rom bank table */
 } FXRegs_s;
 
-extern FXRegs_s FXRegs;
+#ifdef MULTI_INSTANCE
+	#define FXRegs (*FXRegsPtr)
+#endif
+
+extern INSTANCE FXRegs_s FXRegs;
 
 enum /* GSU registers */
 {
@@ -198,6 +210,41 @@ enum /* SFR flags */
 	FLG_IRQ  = (1 << 15)
 };
 
+#define FX_BLOCK_MAX_OPS      16
+#define FX_BLOCK_MAX_PREFIXES 7
+#define FX_BLOCK_COUNT        1024
+#define FX_BLOCK_FLAGS        (FLG_ALT1 | FLG_ALT2 | FLG_B) /* The flags that pick the instruction an opcode is */
+#define FX_BLOCK_HASH(code, flags) ((((uintptr_t) (code)) ^ ((flags) >> 8) * 0x155) & (FX_BLOCK_COUNT - 1))
+
+/* An instruction in a block, along with the ALT, WITH, TO and FROM prefixes before it */
+typedef struct
+{
+	void    (*Op)();          /* Handler for the ALT mode the prefixes leave */
+	uint16_t  PrefixFlags;    /* ALT1, ALT2 and B flags after the prefixes */
+	uint16_t  NextR15;        /* R15 after the instruction if it does not branch */
+	uint8_t   Pipe;           /* Byte after the opcode, which is fetched into the pipe */
+	uint8_t   Prefixes;
+	uint8_t   Done;           /* Instructions in the block up to this one, prefixes included */
+	int8_t    Sreg;           /* Source register the prefixes select, -1 if none */
+	int8_t    Dreg;           /* Destination register the prefixes select, -1 if none */
+} SFXBlockOp;
+
+/* A straight run of instructions in ROM, predecoded for the ALT1, ALT2 and B flags it starts with */
+typedef struct
+{
+	uint8_t*   Code;          /* ROM address of the first opcode, NULL if unused */
+	uint16_t   Flags;
+	uint16_t   Count;         /* Zero if the first instruction is too close to the end of the bank */
+	SFXBlockOp Ops[FX_BLOCK_MAX_OPS];
+	void     (*DelayOp)();    /* Handler for the instruction after the last one if that branches, NULL if none */
+} SFXBlock;
+
+#ifdef MULTI_INSTANCE
+	#define FXBlocks (*FXBlocksPtr)
+#endif
+
+extern INSTANCE SFXBlock* FXBlocks;
+
 /* Test flag */
 #define TF(a) (FXRegs.vStatusReg &   FLG_##a)
 #define CF(a) (FXRegs.vStatusReg &= ~FLG_##a)
@@ -253,8 +300,17 @@ enum /* SFR flags */
 /* Access destination register */
 #define DREG (*FXRegs.pvDreg)
 
-/* Read R14 */
-#define READR14 FXRegs.vRomBuffer = ROM(R14)
+/* Write the plotted pixels to RAM */
+#define FLUSHPIXELS                 \
+	if (FXRegs.vPixelCacheMask)     \
+		fx_flushPixelCache()
+
+/* Read R14, which can be in RAM */
+#define READR14                       \
+	{                                 \
+		FLUSHPIXELS;                  \
+		FXRegs.vRomBuffer = ROM(R14); \
+	}
 
 /* Test and/or read R14 */
 #define TESTR14                \
@@ -296,4 +352,5 @@ extern void (*fx_OpcodeTable[])();
 extern void (*fx_PlotTable[])();
 
 void fx_run(uint32_t nInstructions);
+void fx_flushPixelCache();
 #endif
@@ -3,6 +3,7 @@
 #include "cpuexec.h"
 #include "cx4.h"
 #include "dsp.h"
+#include "fxemu.h"
 #include "sa1.h"
 #include "spc7110.h"
 #include "obc1.h"
@@ -47,6 +48,32 @@ static INLINE void AddCyclesX2InMemAccess(uint32_t address)
 	AddNumCyclesInMemAccess(memory_speed(address) << 1);
 }
 
+static INLINE void IdleRead(intptr_t map, uint32_t address) /* Only registers that change at events can be polled by an idle loop */
+{
+	switch (map)
+	{
+		case MAP_CPU:
+			address &= 0xffff;
+
+			if (address == 0x4210 || address == 0x4212 || (address >= 0x4214 && address <= 0x421f))
+				return;
+
+			break;
+		case MAP_PPU:
+			if (Settings.Chip == GSU && (address & 0xffff) == 0x3030)
+				return;
+
+			break;
+		case MAP_LOROM_SRAM:
+		case MAP_HIROM_SRAM:
+		case MAP_RONLY_SRAM:
+		case MAP_NONE:
+			return;
+	}
+
+	IdleLoop.Clean = false;
+}
+
 uint8_t GetByte(uint32_t Address)
 {
 	uint8_t  byte;
@@ -55,14 +82,13 @@ uint8_t GetByte(uint32_t Address)
 
 	if (GetAddress >= (uint8_t *) MAP_LAST)
 	{
-		if (Memory.BlockIsRAM[block])
-			CPU.WaitPC = CPU.PCAtOpcodeStart;
-
 		byte = GetAddress[Address & 0xffff];
 		AddCyclesInMemAccess(Address);
 		return byte;
 	}
 
+	IdleRead((intptr_t) GetAddress, Address);
+
 	switch ((intptr_t) GetAddress)
 	{
 		case MAP_CPU:
@@ -167,14 +193,14 @@ uint16_t GetWord(uint32_t Address, wrap_t w)
 
 	if (GetAddress >= (uint8_t *) MAP_LAST)
 	{
-		if (Memory.BlockIsRAM[block])
-			CPU.WaitPC = CPU.PCAtOpcodeStart;
-
 		word = READ_WORD(GetAddress + (Address & 0xffff));
 		AddCyclesX2InMemAccess(Address);
 		return word;
 	}
 
+	IdleRead((intptr_t) GetAddress, Address);
+	IdleRead((intptr_t) GetAddress, Address + 1);
+
 	switch ((intptr_t) GetAddress)
 	{
 		case MAP_CPU:
@@ -275,17 +301,25 @@ void SetByte(uint8_t Byte, uint32_t Address)
 {
 	int32_t  block = (Address & 0xffffff) >> MEMMAP_SHIFT;
 	uint8_t* SetAddress = Memory.WriteMap[block];
-	CPU.WaitPC = 0;
+	IdleLoop.Clean = false;
 
 	if (SetAddress >= (uint8_t *) MAP_LAST)
 	{
 		SetAddress += Address & 0xffff;
 
-		if ((Settings.Chip == SA_1) && (SetAddress == SA1.WaitByteAddress1 || SetAddress == SA1.WaitByteAddress2))
+		if (Settings.Chip == SA_1)
 		{
-			SA1.Executing = (SA1.Opcodes != NULL);
-			SA1.WaitCounter = 0;
+			if (SA1.CatchUpSteps && SA1SharesAddress(SetAddress))
+				SA1CatchUp();
+
+			if (SetAddress == SA1.WaitByteAddress1 || SetAddress == SA1.WaitByteAddress2)
+			{
+				SA1.Executing = (SA1.Opcodes != NULL);
+				SA1.WaitCounter = 0;
+			}
 		}
+		else if (Settings.Chip == GSU && (uintptr_t) (SetAddress - Memory.SRAM) < sizeof(Memory.SRAM))
+			SuperFXCatchUp();
 
 		*SetAddress = Byte;
 		AddCyclesInMemAccess(Address);
@@ -324,11 +358,13 @@ void SetByte(uint8_t Byte, uint32_t Address)
 			AddCyclesInMemAccess(Address);
 			return;
 		case MAP_BWRAM:
+			SA1CatchUp();
 			Memory.BWRAM[(Address & 0x7fff) - 0x6000] = Byte;
 			CPU.SRAMModified = true;
 			AddCyclesInMemAccess(Address);
 			return;
 		case MAP_SA1RAM:
+			SA1CatchUp();
 			Memory.SRAM[Address & 0xffff] = Byte;
 			SA1.Executing = !SA1.Waiting;
 			AddCyclesInMemAccess(Address);
@@ -401,7 +437,7 @@ void SetWord(uint16_t Word, uint32_t Address, wrap_t w, writeorder_t o)
 		return;
 	}
 
-	CPU.WaitPC = 0;
+	IdleLoop.Clean = false;
 	block = (Address & 0xffffff) >> MEMMAP_SHIFT;
 	SetAddress = Memory.WriteMap[block];
 
@@ -409,11 +445,19 @@ void SetWord(uint16_t Word, uint32_t Address, wrap_t w, writeorder_t o)
 	{
 		SetAddress += Address & 0xffff;
 
-		if ((Settings.Chip == SA_1) && (SetAddress == SA1.WaitByteAddress1 || SetAddress == SA1.WaitByteAddress2))
+		if (Settings.Chip == SA_1)
 		{
-			SA1.Executing = (SA1.Opcodes != NULL);
-			SA1.WaitCounter = 0;
+			if (SA1.CatchUpSteps && SA1SharesAddress(SetAddress))
+				SA1CatchUp();
+
+			if (SetAddress == SA1.WaitByteAddress1 || SetAddress == SA1.WaitByteAddress2)
+			{
+				SA1.Executing = (SA1.Opcodes != NULL);
+				SA1.WaitCounter = 0;
+			}
 		}
+		else if (Settings.Chip == GSU && (uintptr_t) (SetAddress - Memory.SRAM) < sizeof(Memory.SRAM))
+			SuperFXCatchUp();
 
 		WRITE_WORD(SetAddress, Word);
 		AddCyclesX2InMemAccess(Address);
@@ -502,11 +546,13 @@ void SetWord(uint16_t Word, uint32_t Address, wrap_t w, writeorder_t o)
 			AddCyclesX2InMemAccess(Address);
 			return;
 		case MAP_BWRAM:
+			SA1CatchUp();
 			WRITE_WORD(Memory.BWRAM + (Address & 0x7fff) - 0x6000, Word);
 			CPU.SRAMModified = true;
 			AddCyclesX2InMemAccess(Address);
 			return;
 		case MAP_SA1RAM:
+			SA1CatchUp();
 			WRITE_WORD(Memory.SRAM + (Address & 0xffff), Word);
 			SA1.Executing = !SA1.Waiting;
 			AddCyclesX2InMemAccess(Address);
@@ -6,6 +6,7 @@
 #include "cpuexec.h"
 #include "display.h"
 #include "gfx.h"
+#include "gfxthread.h"
 #include "apu.h"
 #include "cheats.h"
 #include "math.h"
@@ -15,6 +16,7 @@
 #define M7 19
 
 void ComputeClipWindows();
+static uint8_t PrepareScreenUpdate();
 
 extern uint8_t BitShifts[8][4];
 extern uint8_t TileShifts[8][4];
@@ -22,19 +24,6 @@ extern uint8_t PaletteShifts[8][4];
 extern uint8_t PaletteMasks[8][4];
 extern uint8_t Depths[8][4];
 
-extern NormalTileRenderer  DrawTilePtr;
-extern ClippedTileRenderer DrawClippedTilePtr;
-extern NormalTileRenderer  DrawHiResTilePtr;
-extern ClippedTileRenderer DrawHiResClippedTilePtr;
-extern LargePixelRenderer  DrawLargePixelPtr;
-
-extern SBG BG;
-
-extern SLineData       LineData[240];
-extern SLineMatrixData LineMatrixData[240];
-
-extern uint8_t Mode7Depths[2];
-
 #define CLIP_10_BIT_SIGNED(a) \
 	((a) & ((1 << 10) - 1)) + (((((a) & (1 << 13)) ^ (1 << 13)) - (1 << 13)) >> 3)
 
@@ -106,13 +95,22 @@ void DrawLargePixel16Add1_2(uint32_t Tile, int32_t Offset, uint32_t StartPixel,
 void DrawLargePixel16Sub(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Pixels, uint32_t StartLine, uint32_t LineCount);
 void DrawLargePixel16Sub1_2(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Pixels, uint32_t StartLine, uint32_t LineCount);
 
-bool InitGFX()
+static uint16_t* ZeroTable;
+#if !USE_RGB565
+static uint16_t* X2Table;
+static uint16_t* ZeroOrX2Table;
+#endif
+
+bool InitGFXTables() /* Build the lookup tables that are shared by every context */
 {
 	uint32_t r, g, b;
 	uint32_t PixelOdd  = 1;
 	uint32_t PixelEven = 2;
 	uint8_t  bitshift;
 
+	if (ZeroTable)
+		return true;
+
 	for (bitshift = 0; bitshift < 4; bitshift++)
 	{
 		int32_t i;
@@ -234,45 +232,28 @@ bool InitGFX()
 		PixelOdd <<= 2;
 	}
 
-	GFX.RealPitch                    =   GFX.Pitch;
-	GFX.ZPitch                       =   GFX.Pitch;
-	GFX.ZPitch                       >>= 1;
-	GFX.Delta                        =   (GFX.SubScreen - GFX.Screen) >> 1;
-	GFX.DepthDelta                   =   GFX.SubZBuffer - GFX.ZBuffer;
-	IPPU.OBJChanged                  =   true;
-	IPPU.DirectColourMapsNeedRebuild =   true;
-	GFX.PixSize                      =   1;
-	DrawTilePtr                      =   DrawTile16;
-	DrawClippedTilePtr               =   DrawClippedTile16;
-	DrawLargePixelPtr                =   DrawLargePixel16;
-	DrawHiResTilePtr                 =   DrawTile16;
-	DrawHiResClippedTilePtr          =   DrawClippedTile16;
-	GFX.PPL                          =   GFX.Pitch >> 1;
-	GFX.PPLx2                        =   GFX.Pitch;
-	FixColourBrightness();
-
 #if USE_RGB565
-	GFX.Zero = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
+	ZeroTable = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
 
-	if (!GFX.Zero)
+	if (!ZeroTable)
 		return false;
 #else
-	GFX.X2 = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
-	GFX.Zero = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
-	GFX.ZeroOrX2 = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
+	X2Table = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
+	ZeroTable = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
+	ZeroOrX2Table = (uint16_t*) calloc(0x10000, sizeof(uint16_t));
 
-	if (!GFX.X2 || !GFX.Zero || !GFX.ZeroOrX2)
+	if (!X2Table || !ZeroTable || !ZeroOrX2Table)
 	{
-		if (GFX.X2)
-			free(GFX.X2);
+		if (X2Table)
+			free(X2Table);
 
-		if (GFX.Zero)
-			free(GFX.Zero);
+		if (ZeroTable)
+			free(ZeroTable);
 
-		if (GFX.ZeroOrX2)
-			free(GFX.ZeroOrX2);
+		if (ZeroOrX2Table)
+			free(ZeroOrX2Table);
 
-		GFX.X2 = GFX.Zero = GFX.ZeroOrX2 = NULL;
+		X2Table = ZeroTable = ZeroOrX2Table = NULL;
 		return false;
 	}
 
@@ -299,8 +280,8 @@ bool InitGFX()
 				if (b2 > MAX_BLUE)
 					b2 = MAX_BLUE;
 
-				GFX.X2 [BUILD_PIXEL2(r, g, b)] = BUILD_PIXEL2(r2, g2, b2);
-				GFX.X2 [BUILD_PIXEL2(r, g, b) & ~ALPHA_BITS_MASK] = BUILD_PIXEL2(r2, g2, b2);
+				X2Table [BUILD_PIXEL2(r, g, b)] = BUILD_PIXEL2(r2, g2, b2);
+				X2Table [BUILD_PIXEL2(r, g, b) & ~ALPHA_BITS_MASK] = BUILD_PIXEL2(r2, g2, b2);
 			}
 		}
 	}
@@ -335,8 +316,8 @@ bool InitGFX()
 				else
 					b2 = (b2 << 1) & MAX_BLUE;
 
-				GFX.ZeroOrX2[BUILD_PIXEL2(r, g, b)]                    = BUILD_PIXEL2(r2,              g2,              b2);
-				GFX.ZeroOrX2[BUILD_PIXEL2(r, g, b) & ~ALPHA_BITS_MASK] = BUILD_PIXEL2(MATH_MAX(1, r2), MATH_MAX(1, g2), MATH_MAX(1, b2));
+				ZeroOrX2Table[BUILD_PIXEL2(r, g, b)]                    = BUILD_PIXEL2(r2,              g2,              b2);
+				ZeroOrX2Table[BUILD_PIXEL2(r, g, b) & ~ALPHA_BITS_MASK] = BUILD_PIXEL2(MATH_MAX(1, r2), MATH_MAX(1, g2), MATH_MAX(1, b2));
 			}
 		}
 	}
@@ -371,8 +352,8 @@ bool InitGFX()
 				else
 					b2 = 0;
 
-				GFX.Zero[BUILD_PIXEL2(r, g, b)]                    = BUILD_PIXEL2(r2, g2, b2);
-				GFX.Zero[BUILD_PIXEL2(r, g, b) & ~ALPHA_BITS_MASK] = BUILD_PIXEL2(r2, g2, b2);
+				ZeroTable[BUILD_PIXEL2(r, g, b)]                    = BUILD_PIXEL2(r2, g2, b2);
+				ZeroTable[BUILD_PIXEL2(r, g, b) & ~ALPHA_BITS_MASK] = BUILD_PIXEL2(r2, g2, b2);
 			}
 		}
 	}
@@ -380,23 +361,72 @@ bool InitGFX()
 	return true;
 }
 
-void DeinitGFX() /* Free any memory allocated in InitGFX */
+void DeinitGFXTables()
 {
 #if !USE_RGB565
-	if (GFX.X2)
-		free(GFX.X2);
+	if (X2Table)
+		free(X2Table);
 
-	if (GFX.ZeroOrX2)
-		free(GFX.ZeroOrX2);
+	if (ZeroOrX2Table)
+		free(ZeroOrX2Table);
 
-	GFX.X2 = GFX.ZeroOrX2 = NULL;
+	X2Table = ZeroOrX2Table = NULL;
 #endif
 
-	if (GFX.Zero == NULL)
+	if (ZeroTable == NULL)
 		return;
 
-	free(GFX.Zero);
+	free(ZeroTable);
+	ZeroTable = NULL;
+}
+
+bool InitGFX()
+{
+	if (!InitGFXTables())
+		return false;
+
+	GFX.RealPitch                    =   GFX.Pitch;
+	GFX.ZPitch                       =   GFX.Pitch;
+	GFX.ZPitch                       >>= 1;
+	GFX.Delta                        =   (GFX.SubScreen - GFX.Screen) >> 1;
+	GFX.DepthDelta                   =   GFX.SubZBuffer - GFX.ZBuffer;
+	IPPU.OBJChanged                  =   true;
+	IPPU.DirectColourMapsNeedRebuild =   true;
+	GFX.PixSize                      =   1;
+	GFX.VRAM                         =   Memory.VRAM;
+	DrawTilePtr                      =   DrawTile16;
+	DrawClippedTilePtr               =   DrawClippedTile16;
+	DrawLargePixelPtr                =   DrawLargePixel16;
+	DrawHiResTilePtr                 =   DrawTile16;
+	DrawHiResClippedTilePtr          =   DrawClippedTile16;
+	GFX.PPL                          =   GFX.Pitch >> 1;
+	GFX.PPLx2                        =   GFX.Pitch;
+	FixColourBrightness();
+
+	GFX.Zero                         =   ZeroTable;
+#if !USE_RGB565
+	GFX.X2                           =   X2Table;
+	GFX.ZeroOrX2                     =   ZeroOrX2Table;
+#endif
+#ifdef THREADED_RENDER
+	InitRenderThread(); /* Without it the screen is simply drawn on this thread */
+#endif
+
+	return true;
+}
+
+void DeinitGFX()
+{
+#ifdef THREADED_RENDER
+	DeinitRenderThread();
+#endif
 	GFX.Zero = NULL;
+#if !USE_RGB565
+	GFX.X2 = GFX.ZeroOrX2 = NULL;
+#endif
+#ifndef MULTI_INSTANCE
+	DeinitGFXTables(); /* Otherwise they are freed with the last context */
+#endif
 }
 
 void BuildDirectColourMaps()
@@ -462,13 +492,77 @@ void StartScreenRefresh()
 
 	if (++IPPU.FrameCount == (Settings.PAL ? 50 : 60))
 		IPPU.FrameCount = 0;
+
+	IPPU.PPUChanged = false;
+	IPPU.SkipScreen = false;
+}
+
+/* Copies from to to when they differ and says whether they did */
+static bool UpdateSnapshot(void* to, const void* from, size_t size)
+{
+	if (!memcmp(to, from, size))
+		return false;
+
+	memcpy(to, from, size);
+	return true;
+}
+
+/* A frame that nothing changed the PPU in part way through is drawn from the registers, VRAM, CGRAM and OAM it ended
+ * with, plus the scroll and Mode 7 parameters of each line. When all of them match the last frame drawn, so does the
+ * picture. Interlaced frames alternate between two fields, so they never match. */
+static bool SameScreen()
+{
+	SScreenSnapshot* s       = &ScreenSnapshot;
+	size_t           lines   = PPU.ScreenHeight;
+	bool             changed = !s->Valid;
+	uint8_t          regs[sizeof(s->Registers)];
+
+#ifdef THREADED_RENDER
+	/* Lines that were already sent to the render thread were drawn without the VRAM changed since */
+	if (RenderThread && IPPU.PreviousLine > 0 && memchr(IPPU.TileCached[TILE_2BIT], 0, MAX_2BIT_TILES))
+		IPPU.PPUChanged = true;
+#endif
+
+	if (IPPU.PPUChanged || IPPU.Interlace)
+	{
+		s->Valid = false;
+		return false;
+	}
+
+	memcpy(regs, Memory.FillRAM + 0x2100, 2);           /* INIDISP, OBSEL */
+	memcpy(regs + 2, Memory.FillRAM + 0x2105, 8);       /* BGMODE to BG34NBA */
+	regs[10] = Memory.FillRAM[0x211a];                  /* M7SEL */
+	memcpy(regs + 11, Memory.FillRAM + 0x2123, 17);     /* Windows, colour math and SETINI */
+	regs[28] = PPU.FixedColourRed;
+	regs[29] = PPU.FixedColourGreen;
+	regs[30] = PPU.FixedColourBlue;
+	regs[31] = PPU.FirstSprite;
+
+	changed |= UpdateSnapshot(s->Registers, regs, sizeof(regs));
+	changed |= UpdateSnapshot(&s->Width, &IPPU.RenderedScreenWidth, sizeof(s->Width));
+	changed |= UpdateSnapshot(&s->Height, &IPPU.RenderedScreenHeight, sizeof(s->Height));
+	changed |= UpdateSnapshot(s->CGDATA, PPU.CGDATA, sizeof(s->CGDATA));
+	changed |= UpdateSnapshot(s->OAMData, PPU.OAMData, sizeof(s->OAMData));
+	changed |= UpdateSnapshot(s->Lines, LineData, lines * sizeof(SLineData));
+	changed |= UpdateSnapshot(s->MatrixLines, LineMatrixData, lines * sizeof(SLineMatrixData));
+	changed |= UpdateSnapshot(s->VRAM, Memory.VRAM, sizeof(s->VRAM));
+	s->Valid = true;
+	return !changed;
 }
 
 void EndScreenRefresh()
 {
 	if (IPPU.RenderThisFrame)
 	{
+		IPPU.SkipScreen = Settings.SkipUnchangedFrames && SameScreen();
+
+		if (!Settings.SkipUnchangedFrames)
+			ScreenSnapshot.Valid = false;
+
 		FLUSH_REDRAW();
+#ifdef THREADED_RENDER
+		WaitRenderThread();
+#endif
 
 		if (IPPU.ColorsChanged)
 		{
@@ -523,6 +617,18 @@ void RenderLine(uint8_t C)
 	}
 
 	IPPU.CurrentLine = C + 1;
+
+#ifdef THREADED_RENDER
+	/* Keep the render thread busy while the rest of the frame is emulated. The lines of the next frame that are run
+	 * before the main loop returns wait for it, as they do without the render thread, since GFX.Screen is about to be
+	 * sent. */
+	if (RenderThread && !finishedFrame && IPPU.CurrentLine - IPPU.PreviousLine >= RENDER_THREAD_LINES)
+	{
+		QueueScreenUpdate(PrepareScreenUpdate());
+		IPPU.PreviousLine = IPPU.CurrentLine;
+		PERF_COUNT(PERF_SCANLINES, GFX.EndY + 1 - GFX.StartY);
+	}
+#endif
 }
 
 static INLINE void SelectTileRenderer(bool normal)
@@ -1029,14 +1135,14 @@ static void DrawBackgroundMosaic(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8
 	else
 		BG.StartPalette = 0;
 
-	SC0 = (uint16_t*) (Memory.VRAM + (PPU.BG[bg].SCBase << 1));
+	SC0 = (uint16_t*) (GFX.VRAM + (PPU.BG[bg].SCBase << 1));
 
 	if (PPU.BG[bg].SCSize & 1)
 		SC1 = SC0 + 1024;
 	else
 		SC1 = SC0;
 
-	if (((uint8_t*) SC1 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC1 - GFX.VRAM) >= 0x10000)
 		SC1 -= 0x08000;
 
 	if (PPU.BG[bg].SCSize & 2)
@@ -1044,7 +1150,7 @@ static void DrawBackgroundMosaic(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8
 	else
 		SC2 = SC0;
 
-	if (((uint8_t*) SC2 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC2 - GFX.VRAM) >= 0x10000)
 		SC2 -= 0x08000;
 
 	if (PPU.BG[bg].SCSize & 1)
@@ -1052,7 +1158,7 @@ static void DrawBackgroundMosaic(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8
 	else
 		SC3 = SC2;
 
-	if (((uint8_t*) SC3 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC3 - GFX.VRAM) >= 0x10000)
 		SC3 -= 0x08000;
 
 	if (BG.TileSize == 16)
@@ -1229,7 +1335,7 @@ static void DrawBackgroundOffset(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8
 	depths[0]       = Z1;
 	depths[1]       = Z2;
 	BG.StartPalette = 0;
-	BPS0            = (uint16_t*) (Memory.VRAM + (PPU.BG[2].SCBase << 1));
+	BPS0            = (uint16_t*) (GFX.VRAM + (PPU.BG[2].SCBase << 1));
 
 	if (PPU.BG[2].SCSize & 1)
 		BPS1 = BPS0 + 1024;
@@ -1246,14 +1352,14 @@ static void DrawBackgroundOffset(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8
 	else
 		BPS3 = BPS2;
 
-	SC0 = (uint16_t*) (Memory.VRAM + (PPU.BG[bg].SCBase << 1));
+	SC0 = (uint16_t*) (GFX.VRAM + (PPU.BG[bg].SCBase << 1));
 
 	if (PPU.BG[bg].SCSize & 1)
 		SC1 = SC0 + 1024;
 	else
 		SC1 = SC0;
 
-	if (((uint8_t*) SC1 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC1 - GFX.VRAM) >= 0x10000)
 		SC1 -= 0x08000;
 
 	if (PPU.BG[bg].SCSize & 2)
@@ -1261,7 +1367,7 @@ static void DrawBackgroundOffset(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8
 	else
 		SC2 = SC0;
 
-	if (((uint8_t*) SC2 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC2 - GFX.VRAM) >= 0x10000)
 		SC2 -= 0x08000;
 
 	if (PPU.BG[bg].SCSize & 1)
@@ -1269,7 +1375,7 @@ static void DrawBackgroundOffset(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8
 	else
 		SC3 = SC2;
 
-	if (((uint8_t*) SC3 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC3 - GFX.VRAM) >= 0x10000)
 		SC3 -= 0x08000;
 
 	OffsetEnableMask = 1 << (bg + 13);
@@ -1525,22 +1631,22 @@ static void DrawBackgroundMode5(uint32_t bg, uint8_t Z1, uint8_t Z2)
 	depths[1]       = Z2;
 	BG.StartPalette = 0;
 
-	SC0 = (uint16_t*) (Memory.VRAM + (PPU.BG[bg].SCBase << 1));
+	SC0 = (uint16_t*) (GFX.VRAM + (PPU.BG[bg].SCBase << 1));
 
 	if ((PPU.BG[bg].SCSize & 1))
 		SC1 = SC0 + 1024;
 	else
 		SC1 = SC0;
 
-	if ((SC1 - (uint16_t*) Memory.VRAM) > 0x10000)
-		SC1 = (uint16_t*) (Memory.VRAM + ((((uint8_t*) SC1) - Memory.VRAM) % 0x10000));
+	if ((SC1 - (uint16_t*) GFX.VRAM) > 0x10000)
+		SC1 = (uint16_t*) (GFX.VRAM + ((((uint8_t*) SC1) - GFX.VRAM) % 0x10000));
 
 	if ((PPU.BG[bg].SCSize & 2))
 		SC2 = SC1 + 1024;
 	else
 		SC2 = SC0;
 
-	if (((uint8_t*) SC2 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC2 - GFX.VRAM) >= 0x10000)
 		SC2 -= 0x08000;
 
 	if ((PPU.BG[bg].SCSize & 1))
@@ -1548,7 +1654,7 @@ static void DrawBackgroundMode5(uint32_t bg, uint8_t Z1, uint8_t Z2)
 	else
 		SC3 = SC2;
 
-	if (((uint8_t*) SC3 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC3 - GFX.VRAM) >= 0x10000)
 		SC3 -= 0x08000;
 
 	if (BG.TileSize == 16)
@@ -1811,22 +1917,22 @@ static void DrawBackground(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8_t Z2)
 	else
 		BG.StartPalette = 0;
 
-	SC0 = (uint16_t*) (Memory.VRAM + (PPU.BG[bg].SCBase << 1));
+	SC0 = (uint16_t*) (GFX.VRAM + (PPU.BG[bg].SCBase << 1));
 
 	if (PPU.BG[bg].SCSize & 1)
 		SC1 = SC0 + 1024;
 	else
 		SC1 = SC0;
 
-	if (SC1 >= (uint16_t*) (Memory.VRAM + 0x10000))
-		SC1 = (uint16_t*) (Memory.VRAM + (((uint8_t*) SC1 - &Memory.VRAM[0]) % 0x10000));
+	if (SC1 >= (uint16_t*) (GFX.VRAM + 0x10000))
+		SC1 = (uint16_t*) (GFX.VRAM + (((uint8_t*) SC1 - &GFX.VRAM[0]) % 0x10000));
 
 	if (PPU.BG[bg].SCSize & 2)
 		SC2 = SC1 + 1024;
 	else
 		SC2 = SC0;
 
-	if (((uint8_t*) SC2 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC2 - GFX.VRAM) >= 0x10000)
 		SC2 -= 0x08000;
 
 	if (PPU.BG[bg].SCSize & 1)
@@ -1834,7 +1940,7 @@ static void DrawBackground(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8_t Z2)
 	else
 		SC3 = SC2;
 
-	if (((uint8_t*) SC3 - Memory.VRAM) >= 0x10000)
+	if (((uint8_t*) SC3 - GFX.VRAM) >= 0x10000)
 		SC3 -= 0x08000;
 
 	if (BG.TileSize == 16)
@@ -2073,7 +2179,7 @@ static void DrawBackground(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8_t Z2)
 	uint8_t*         Depth;                                                                                \
 	SLineMatrixData* l;                                                                                    \
 	(void) ScreenColors;                                                                                   \
-	VRAM1 = Memory.VRAM + 1;                                                                               \
+	VRAM1 = GFX.VRAM + 1;                                                                                  \
 	                                                                                                       \
 	if (GFX.r2130 & 1)                                                                                     \
 	{                                                                                                      \
@@ -2155,7 +2261,7 @@ static void DrawBackground(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8_t Z2)
 				{                                                                                          \
 					int32_t  X        = ((AA + BB) >> 8) & 0x3ff;                                          \
 					int32_t  Y        = ((CC + DD) >> 8) & 0x3ff;                                          \
-					uint8_t* TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);     \
+					uint8_t* TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);        \
 					uint32_t b        = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                         \
 					GFX.Z1            = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                     \
 					                                                                                       \
@@ -2175,7 +2281,7 @@ static void DrawBackground(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8_t Z2)
 					                                                                                       \
 					if (((X | Y) & ~0x3ff) == 0)                                                           \
 					{                                                                                      \
-						uint8_t* TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
+						uint8_t* TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);    \
 						uint32_t b        = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                     \
 						GFX.Z1            = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                 \
 						                                                                                   \
@@ -2207,6 +2313,215 @@ static void DrawBackground(uint32_t BGMode, uint32_t bg, uint8_t Z1, uint8_t Z2)
 		}                                                                                                  \
 	}
 
+#ifdef COLOUR_MATH_SSE2
+/* Draws 8 pixels of a Mode 7 line. The texel coordinates of all 8 are worked out at once from those of the first pixel
+ * (XPos and YPos, in 1/256ths) and the steps between pixels. SSE2 cannot gather, so the tile map and the tiles are read
+ * one pixel at a time, but the priority, the depth test and the colour math are done for all 8. Pixels outside the
+ * 1024x1024 map come from tile 0 at (OutsideX, OutsideY) when the map is set to repeat it. */
+static ALWAYS_INLINE void DrawMode7PixelsSSE2(uint16_t* p, uint8_t* d, const uint8_t* sd, const uint16_t* sp, int32_t XPos, int32_t YPos, __m128i StepX0, __m128i StepX1, __m128i StepY0, __m128i StepY1, int32_t OutsideX, int32_t OutsideY, int32_t dir, const uint16_t* ScreenColors, uint8_t Op)
+{
+	uint16_t Map[8], Texel[8], Pixels[8], Colours[8];
+	uint32_t Outside = 0;
+	int32_t  i;
+	__m128i  zero  = _mm_setzero_si128();
+	__m128i  wrap  = _mm_set1_epi32(0x3ff);
+	__m128i  X0    = _mm_srai_epi32(_mm_add_epi32(_mm_set1_epi32(XPos), StepX0), 8);
+	__m128i  X1    = _mm_srai_epi32(_mm_add_epi32(_mm_set1_epi32(XPos), StepX1), 8);
+	__m128i  Y0    = _mm_srai_epi32(_mm_add_epi32(_mm_set1_epi32(YPos), StepY0), 8);
+	__m128i  Y1    = _mm_srai_epi32(_mm_add_epi32(_mm_set1_epi32(YPos), StepY1), 8);
+	__m128i  pix, colours, depth, z, draw;
+
+	if (PPU.Mode7Repeat)
+	{
+		__m128i inside0 = _mm_cmpeq_epi32(_mm_andnot_si128(wrap, _mm_or_si128(X0, Y0)), zero);
+		__m128i inside1 = _mm_cmpeq_epi32(_mm_andnot_si128(wrap, _mm_or_si128(X1, Y1)), zero);
+		Outside         = ~_mm_movemask_epi8(_mm_packs_epi32(inside0, inside1)) & 0xffff;
+	}
+
+	X0 = _mm_and_si128(X0, wrap);
+	X1 = _mm_and_si128(X1, wrap);
+	Y0 = _mm_and_si128(Y0, wrap);
+	Y1 = _mm_and_si128(Y1, wrap);
+	_mm_storeu_si128((__m128i*) Map, _mm_packs_epi32(
+		_mm_add_epi32(_mm_slli_epi32(_mm_andnot_si128(_mm_set1_epi32(7), Y0), 5), _mm_andnot_si128(_mm_set1_epi32(1), _mm_srli_epi32(X0, 2))),
+		_mm_add_epi32(_mm_slli_epi32(_mm_andnot_si128(_mm_set1_epi32(7), Y1), 5), _mm_andnot_si128(_mm_set1_epi32(1), _mm_srli_epi32(X1, 2)))));
+	_mm_storeu_si128((__m128i*) Texel, _mm_packs_epi32(
+		_mm_add_epi32(_mm_slli_epi32(_mm_and_si128(Y0, _mm_set1_epi32(7)), 4), _mm_slli_epi32(_mm_and_si128(X0, _mm_set1_epi32(7)), 1)),
+		_mm_add_epi32(_mm_slli_epi32(_mm_and_si128(Y1, _mm_set1_epi32(7)), 4), _mm_slli_epi32(_mm_and_si128(X1, _mm_set1_epi32(7)), 1))));
+
+	for (i = 0; i < 8; i++)
+	{
+		uint32_t b;
+
+		if (!(Outside & (1 << (i << 1))))
+			b = GFX.VRAM[1 + (GFX.VRAM[Map[i]] << 7) + Texel[i]];
+		else if (PPU.Mode7Repeat == 3)
+			b = GFX.VRAM[1 + ((OutsideY & 7) << 4) + (((OutsideX + i * dir) & 7) << 1)];
+		else
+			b = 0;
+
+		Pixels[i]  = b;
+		Colours[i] = ScreenColors[b & GFX.Mode7Mask];
+	}
+
+	pix   = _mm_loadu_si128((const __m128i*) Pixels);
+	depth = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) d), zero);
+	z     = SelectSSE2(_mm_cmpeq_epi16(_mm_and_si128(pix, _mm_set1_epi16(GFX.Mode7PriorityMask)), zero), _mm_set1_epi16(Mode7Depths[0]), _mm_set1_epi16(Mode7Depths[1]));
+	draw  = _mm_andnot_si128(_mm_cmpeq_epi16(_mm_and_si128(pix, _mm_set1_epi16(GFX.Mode7Mask)), zero), _mm_cmpgt_epi16(z, depth));
+
+	if (!_mm_movemask_epi8(draw))
+		return;
+
+	colours = ColourMathSSE2(_mm_loadu_si128((const __m128i*) Colours), _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) sd), zero), sp, Op);
+	_mm_storeu_si128((__m128i*) p, SelectSSE2(draw, colours, _mm_loadu_si128((const __m128i*) p)));
+	depth = SelectSSE2(draw, z, depth);
+	_mm_storel_epi64((__m128i*) d, _mm_packus_epi16(depth, depth));
+}
+
+/* Walks the lines and clip windows like RENDER_BACKGROUND_MODE7, but draws 8 pixels at a time. The last 8 of a span may
+ * overlap the ones before them, which is harmless since a pixel that was drawn no longer passes the depth test. Spans
+ * narrower than 8 pixels go through a line of their own, with the pixels past them hidden behind the highest depth. */
+static ALWAYS_INLINE void DrawBGMode7BackgroundSSE2(uint8_t* Screen, int32_t bg, uint8_t Op)
+{
+	uint32_t         clip;
+	uint32_t         Left  = 0;
+	uint32_t         Right = 256;
+	uint32_t         ClipCount;
+	uint16_t*        ScreenColors = IPPU.ScreenColors;
+	uint32_t         Line;
+	uint8_t*         Depth;
+	SLineMatrixData* l;
+
+	if (GFX.r2130 & 1)
+	{
+		if (IPPU.DirectColourMapsNeedRebuild)
+			BuildDirectColourMaps();
+
+		ScreenColors = DirectColourMaps[0];
+	}
+
+	ClipCount = GFX.pCurrentClip->Count[bg];
+
+	if (!ClipCount)
+		ClipCount = 1;
+
+	Screen += GFX.StartY * GFX.Pitch;
+	Depth   = GFX.DB + GFX.StartY * GFX.PPL;
+	l       = LineMatrixData + GFX.StartY;
+
+	for (Line = GFX.StartY; Line <= GFX.EndY; Line++, Screen += GFX.Pitch, Depth += GFX.PPL, l++)
+	{
+		int32_t yy;
+		int32_t BB, DD;
+		int32_t HOffset = ((int32_t) LineData[Line].BG[0].HOffset << M7) >> M7;
+		int32_t VOffset = ((int32_t) LineData[Line].BG[0].VOffset << M7) >> M7;
+		int32_t CentreX = ((int32_t) l->CentreX << M7) >> M7;
+		int32_t CentreY = ((int32_t) l->CentreY << M7) >> M7;
+
+		if (PPU.Mode7VFlip)
+			yy = 255 - (int32_t) Line;
+		else
+			yy = Line;
+
+		yy += CLIP_10_BIT_SIGNED(VOffset - CentreY);
+		BB  = l->MatrixB * yy + (CentreX << 8);
+		DD  = l->MatrixD * yy + (CentreY << 8);
+
+		for (clip = 0; clip < ClipCount; clip++)
+		{
+			uint16_t* p;
+			uint8_t*  d;
+			int32_t   startx, dir, aa, cc, xx, AA, CC, Count, n;
+			__m128i   StepX0, StepX1, StepY0, StepY1;
+
+			if (GFX.pCurrentClip->Count[bg])
+			{
+				Left  = GFX.pCurrentClip->Left[clip][bg];
+				Right = GFX.pCurrentClip->Right[clip][bg];
+
+				if (Right <= Left)
+					continue;
+			}
+
+			p     = (uint16_t*) Screen + Left;
+			d     = Depth + Left;
+			Count = Right - Left;
+
+			if (PPU.Mode7HFlip)
+			{
+				startx = Right - 1;
+				dir    = -1;
+				aa     = -l->MatrixA;
+				cc     = -l->MatrixC;
+			}
+			else
+			{
+				startx = Left;
+				dir    = 1;
+				aa     = l->MatrixA;
+				cc     = l->MatrixC;
+			}
+
+			xx     = startx + CLIP_10_BIT_SIGNED(HOffset - CentreX);
+			AA     = l->MatrixA * xx + BB;
+			CC     = l->MatrixC * xx + DD;
+			StepX0 = _mm_setr_epi32(0, aa, aa * 2, aa * 3);
+			StepX1 = _mm_add_epi32(StepX0, _mm_set1_epi32(aa * 4));
+			StepY0 = _mm_setr_epi32(0, cc, cc * 2, cc * 3);
+			StepY1 = _mm_add_epi32(StepY0, _mm_set1_epi32(cc * 4));
+
+			if (Count < 8)
+			{
+				uint16_t LineScreen[8], LineSubScreen[8];
+				uint8_t  LineDepth[8], LineSubDepth[8];
+				memset(LineScreen, 0, sizeof(LineScreen));
+				memset(LineSubScreen, 0, sizeof(LineSubScreen));
+				memset(LineDepth, 0xff, sizeof(LineDepth));
+				memset(LineSubDepth, 0, sizeof(LineSubDepth));
+				memcpy(LineScreen, p, Count * sizeof(uint16_t));
+				memcpy(LineSubScreen, p + GFX.Delta, Count * sizeof(uint16_t));
+				memcpy(LineDepth, d, Count);
+				memcpy(LineSubDepth, d + GFX.DepthDelta, Count);
+				DrawMode7PixelsSSE2(LineScreen, LineDepth, LineSubDepth, LineSubScreen, AA, CC, StepX0, StepX1, StepY0, StepY1, startx + HOffset, yy + CentreY, dir, ScreenColors, Op);
+				memcpy(p, LineScreen, Count * sizeof(uint16_t));
+				memcpy(d, LineDepth, Count);
+				continue;
+			}
+
+			for (n = 0; n < Count; n += 8)
+			{
+				int32_t k = n > Count - 8 ? Count - 8 : n;
+				DrawMode7PixelsSSE2(p + k, d + k, d + k + GFX.DepthDelta, p + k + GFX.Delta, AA + k * aa, CC + k * cc, StepX0, StepX1, StepY0, StepY1, startx + k * dir + HOffset, yy + CentreY, dir, ScreenColors, Op);
+			}
+		}
+	}
+}
+
+static void DrawBGMode7Background16(uint8_t* Screen, int32_t bg)
+{
+	DrawBGMode7BackgroundSSE2(Screen, bg, MATH_NONE);
+}
+
+static void DrawBGMode7Background16Add(uint8_t* Screen, int32_t bg)
+{
+	DrawBGMode7BackgroundSSE2(Screen, bg, MATH_ADD);
+}
+
+static void DrawBGMode7Background16Add1_2(uint8_t* Screen, int32_t bg)
+{
+	DrawBGMode7BackgroundSSE2(Screen, bg, MATH_ADD1_2);
+}
+
+static void DrawBGMode7Background16Sub(uint8_t* Screen, int32_t bg)
+{
+	DrawBGMode7BackgroundSSE2(Screen, bg, MATH_SUB);
+}
+
+static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
+{
+	DrawBGMode7BackgroundSSE2(Screen, bg, MATH_SUB1_2);
+}
+#else
 static void DrawBGMode7Background16(uint8_t* Screen, int32_t bg)
 {
 	RENDER_BACKGROUND_MODE7(uint16_t, ScreenColors[b & GFX.Mode7Mask]);
@@ -2231,6 +2546,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 {
 	RENDER_BACKGROUND_MODE7(uint16_t, *(d + GFX.DepthDelta) ? (*(d + GFX.DepthDelta) != 1 ? COLOR_SUB1_2(ScreenColors[b & GFX.Mode7Mask], p[GFX.Delta]) : COLOR_SUB(ScreenColors[b & GFX.Mode7Mask], GFX.FixedColour)) : ScreenColors[b & GFX.Mode7Mask]);
 }
+#endif
 
 #define RENDER_BACKGROUND_MODE7_i(TYPE, FUNC, COLORFUNC)                                                                \
 	int32_t          aa, cc;                                                                                            \
@@ -2245,7 +2561,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 	uint32_t         Left            = 0;                                                                               \
 	uint32_t         Right           = 256;                                                                             \
 	bool             allowSimpleCase = false;                                                                           \
-	uint8_t*         VRAM1           = Memory.VRAM + 1;                                                                 \
+	uint8_t*         VRAM1           = GFX.VRAM + 1;                                                                    \
 	uint32_t         b;                                                                                                 \
 	                                                                                                                    \
 	if (GFX.r2130 & 1)                                                                                                  \
@@ -2358,7 +2674,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 					{                                                                                                   \
 						int32_t  X        = ((AA + BB) >> 8) & 0x3ff;                                                   \
 						int32_t  Y        = (DD >> 8) & 0x3ff;                                                          \
-						uint8_t* TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);              \
+						uint8_t* TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);                 \
 						b                 = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                                  \
 						GFX.Z1            = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                              \
 						                                                                                                \
@@ -2384,7 +2700,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 						                                                                                                \
 						if (((X | Y) & ~0x3ff) == 0)                                                                    \
 						{                                                                                               \
-							uint8_t* TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);          \
+							uint8_t* TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);             \
 							b                 = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                              \
 							GFX.Z1            = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                          \
 							                                                                                            \
@@ -2401,7 +2717,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 							uint32_t b;                                                                                 \
 							X        = (x + HOffset) & 7;                                                               \
 							Y        = (yy + CentreY) & 7;                                                              \
-							TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);                   \
+							TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);                      \
 							b        = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                                       \
 							GFX.Z1   = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                                   \
 							                                                                                            \
@@ -2444,7 +2760,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 						uint32_t yPix     = yPos >> 8;                                                                  \
 						uint32_t X        = xPix & 0x3ff;                                                               \
 						uint32_t Y        = yPix & 0x3ff;                                                               \
-						uint8_t* TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);              \
+						uint8_t* TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);                 \
 						b                 = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                                  \
 						GFX.Z1            = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                              \
 						                                                                                                \
@@ -2456,9 +2772,9 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 							/* X10 and Y01 are the X and Y coordinates of the next source point over. */                \
 							uint32_t X10        = (xPix + dir) & 0x3ff;                                                 \
 							uint32_t Y01        = (yPix + (PPU.Mode7VFlip ? -1 : 1)) & 0x3ff;                           \
-							uint8_t* TileData10 = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);      \
-							uint8_t* TileData11 = VRAM1 + (Memory.VRAM[((Y01 & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);    \
-							uint8_t* TileData01 = VRAM1 + (Memory.VRAM[((Y01 & ~7) << 5) + ((X >> 2) & ~1)] << 7);      \
+							uint8_t* TileData10 = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);         \
+							uint8_t* TileData11 = VRAM1 + (GFX.VRAM[((Y01 & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);       \
+							uint8_t* TileData01 = VRAM1 + (GFX.VRAM[((Y01 & ~7) << 5) + ((X >> 2) & ~1)] << 7);         \
 							p1                  = COLORFUNC;                                                            \
 							p1                  = (p1 & FIRST_THIRD_COLOR_MASK) | ((p1 & SECOND_COLOR_MASK) << 16);     \
 							b                   = TileData10[((Y & 7) << 4) + ((X10 & 7) << 1)];                        \
@@ -2535,7 +2851,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 					{                                                                                                   \
 						uint32_t X        = ((AA + BB) >> 8) & 0x3ff;                                                   \
 						uint32_t Y        = ((CC + DD) >> 8) & 0x3ff;                                                   \
-						uint8_t* TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);              \
+						uint8_t* TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);                 \
 						b                 = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                                  \
 						GFX.Z1            = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                              \
 						                                                                                                \
@@ -2550,9 +2866,9 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 							uint32_t Y01        = ((CC + DD01) >> 8) & 0x3ff;                                           \
 							uint32_t X11        = ((AA + BB11) >> 8) & 0x3ff;                                           \
 							uint32_t Y11        = ((CC + DD11) >> 8) & 0x3ff;                                           \
-							uint8_t* TileData10 = VRAM1 + (Memory.VRAM[((Y10 & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);    \
-							uint8_t* TileData01 = VRAM1 + (Memory.VRAM[((Y01 & ~7) << 5) + ((X01 >> 2) & ~1)] << 7);    \
-							uint8_t* TileData11 = VRAM1 + (Memory.VRAM[((Y11 & ~7) << 5) + ((X11 >> 2) & ~1)] << 7);    \
+							uint8_t* TileData10 = VRAM1 + (GFX.VRAM[((Y10 & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);       \
+							uint8_t* TileData01 = VRAM1 + (GFX.VRAM[((Y01 & ~7) << 5) + ((X01 >> 2) & ~1)] << 7);       \
+							uint8_t* TileData11 = VRAM1 + (GFX.VRAM[((Y11 & ~7) << 5) + ((X11 >> 2) & ~1)] << 7);       \
 							p1                  = COLORFUNC;                                                            \
 							b                   = TileData10[((Y10 & 7) << 4) + ((X10 & 7) << 1)];                      \
 							p2                  = COLORFUNC;                                                            \
@@ -2582,7 +2898,7 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 					                                                                                                    \
 					if (((X | Y) & ~0x3ff) == 0)                                                                        \
 					{                                                                                                   \
-						uint8_t* TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);              \
+						uint8_t* TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7);                 \
 						b                 = TileData[((Y & 7) << 4) + ((X & 7) << 1)];                                  \
 						GFX.Z1            = Mode7Depths[(b & GFX.Mode7PriorityMask) >> 7];                              \
 						                                                                                                \
@@ -2595,9 +2911,9 @@ static void DrawBGMode7Background16Sub1_2(uint8_t* Screen, int32_t bg)
 							/* X10 and Y01 are the X and Y coordinates of the next source point over. */                \
 							uint32_t X10        = (xPix + dir) & 0x3ff;                                                 \
 							uint32_t Y01        = (yPix + dir) & 0x3ff;                                                 \
-							uint8_t* TileData10 = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);      \
-							uint8_t* TileData11 = VRAM1 + (Memory.VRAM[((Y01 & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);    \
-							uint8_t* TileData01 = VRAM1 + (Memory.VRAM[((Y01 & ~7) << 5) + ((X >> 2) & ~1)] << 7);      \
+							uint8_t* TileData10 = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);         \
+							uint8_t* TileData11 = VRAM1 + (GFX.VRAM[((Y01 & ~7) << 5) + ((X10 >> 2) & ~1)] << 7);       \
+							uint8_t* TileData01 = VRAM1 + (GFX.VRAM[((Y01 & ~7) << 5) + ((X >> 2) & ~1)] << 7);         \
 							p1                  = COLORFUNC;                                                            \
 							p1                  = (p1 & FIRST_THIRD_COLOR_MASK) | ((p1 & SECOND_COLOR_MASK) << 16);     \
 							b                   = TileData10[((Y & 7) << 4) + ((X10 & 7) << 1)];                        \
@@ -2733,11 +3049,11 @@ static void RenderScreen(uint8_t* Screen, bool sub, bool force_no_add, uint8_t D
 				SelectTileRenderer(sub || !SUB_OR_ADD(4));
 				DrawOBJS(!sub, D);
 			}
-			if (BG0 || ((Memory.FillRAM[0x2133] & 0x40) && BG1))
+			if (BG0 || ((GFX.r2133 & 0x40) && BG1))
 			{
 				int32_t bg;
 
-				if ((Memory.FillRAM[0x2133] & 0x40) && BG1)
+				if ((GFX.r2133 & 0x40) && BG1)
 				{
 					GFX.Mode7Mask         = 0x7f;
 					GFX.Mode7PriorityMask = 0x80;
@@ -2779,16 +3095,11 @@ static void RenderScreen(uint8_t* Screen, bool sub, bool force_no_add, uint8_t D
 	}
 }
 
-void UpdateScreen()
+/* The part of a screen update that the emulation depends on: sprites and windows are set up, and switches to hi-res or
+ * interlaced output change the screen geometry. Returns which of the lines that were already drawn need to be scaled. */
+static uint8_t PrepareScreenUpdate()
 {
-	int32_t x2 = 1;
-	uint32_t starty, endy, black;
-	GFX.S = GFX.Screen;
-	GFX.r2131 = Memory.FillRAM[0x2131];
-	GFX.r212c = Memory.FillRAM[0x212c];
-	GFX.r212d = Memory.FillRAM[0x212d];
-	GFX.r2130 = Memory.FillRAM[0x2130];
-	GFX.Pseudo = Memory.FillRAM [0x2133] & 8;
+	uint8_t rescale = 0;
 
 	if (IPPU.OBJChanged)
 		SetupOBJ();
@@ -2799,77 +3110,99 @@ void UpdateScreen()
 		PPU.RecomputeClipWindows = false;
 	}
 
+	/* The registers the lines are drawn with, so that drawing them does not need the rest of the register space */
+	GFX.r2131  = Memory.FillRAM[0x2131];
+	GFX.r212c  = Memory.FillRAM[0x212c];
+	GFX.r212d  = Memory.FillRAM[0x212d];
+	GFX.r2130  = Memory.FillRAM[0x2130];
+	GFX.r2133  = Memory.FillRAM[0x2133];
+	GFX.Pseudo = GFX.r2133 & 8;
+
+	if (GFX.Pseudo)
+	{
+		GFX.r2131 = 0x5f;
+		GFX.r212c &= (Memory.FillRAM[0x212d] | 0xf0);
+		GFX.r212d |= (Memory.FillRAM[0x212c] & 0x0f);
+		GFX.r2130 |= 2;
+	}
+
 	if ((GFX.EndY = IPPU.CurrentLine - 1) >= PPU.ScreenHeight)
 		GFX.EndY = PPU.ScreenHeight - 1;
 
 	GFX.StartY = IPPU.PreviousLine;
-	PPU.RangeTimeOver |= GFX.OBJLines[GFX.EndY].RTOFlags;
-	starty = GFX.StartY;
-	endy   = GFX.EndY;
 
-	if (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.Interlace || IPPU.DoubleHeightPixels)
+	if (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.Interlace)
 	{
-		if (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.Interlace)
+		IPPU.RenderedScreenWidth = SNES_WIDTH << 1;
+
+		if ((PPU.BGMode == 5 || PPU.BGMode == 6) && !IPPU.DoubleWidthPixels) /* The game has switched from lo-res to hi-res mode part way down the screen. */
 		{
-			IPPU.RenderedScreenWidth = SNES_WIDTH << 1;
-			x2 = 2;
+			rescale                |= RESCALE_WIDTH;
+			IPPU.DoubleWidthPixels  = true;
+			IPPU.HalfWidthPixels    = false;
 		}
 
-		if (IPPU.DoubleHeightPixels)
+		if (IPPU.Interlace && !IPPU.DoubleHeightPixels) /* BJ: And we have to change the height if Interlace gets set, too. */
 		{
-			starty = GFX.StartY * 2;
-			endy = GFX.EndY * 2 + 1;
+			rescale                   |= RESCALE_HEIGHT;
+			IPPU.RenderedScreenHeight  = PPU.ScreenHeight << 1;
+			IPPU.DoubleHeightPixels    = true;
+			GFX.Pitch                  = GFX.RealPitch * 2;
+			GFX.PPL                    = GFX.RealPitch;
+			GFX.PPLx2                  = GFX.RealPitch;
 		}
+	}
 
-		if ((PPU.BGMode == 5 || PPU.BGMode == 6) && !IPPU.DoubleWidthPixels) /* The game has switched from lo-res to hi-res mode part way down the screen. Scale any existing lo-res pixels on screen */
-		{
-			uint32_t y;
+	return rescale;
+}
 
-			for (y = 0; y < starty; y++)
-			{
-				int32_t   x;
-				uint16_t* p = (uint16_t*) (GFX.Screen + y * GFX.RealPitch) + 255;
-				uint16_t* q = (uint16_t*) p + 255;
+/* Draws the lines GFX.StartY to GFX.EndY. It only writes to the screen, the tile cache and the direct colour maps, so
+ * it can run on a copy of the PPU state. */
+void DrawScreenUpdate(uint8_t rescale)
+{
+	int32_t x2 = 1;
+	uint32_t starty, endy, black;
+	GFX.S = GFX.Screen;
+	starty = GFX.StartY;
+	endy   = GFX.EndY;
 
-				for (x = 255; x >= 0; x--, p--, q -= 2)
-					q[0] = q[1] = p[0];
-			}
+	if (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.Interlace)
+		x2 = 2;
 
-			IPPU.DoubleWidthPixels = true;
-			IPPU.HalfWidthPixels   = false;
-		}
+	if (IPPU.DoubleHeightPixels)
+	{
+		starty = GFX.StartY * 2;
+		endy = GFX.EndY * 2 + 1;
+	}
 
-		if (IPPU.Interlace && !IPPU.DoubleHeightPixels) /* BJ: And we have to change the height if Interlace gets set, too. */
+	if (rescale & RESCALE_WIDTH) /* Scale any existing lo-res pixels on screen */
+	{
+		uint32_t y;
+
+		for (y = 0; y < ((rescale & RESCALE_HEIGHT) ? GFX.StartY : starty); y++)
 		{
-			int32_t y;
-			starty                    = GFX.StartY * 2;
-			endy                      = GFX.EndY * 2 + 1;
-			IPPU.RenderedScreenHeight = PPU.ScreenHeight << 1;
-			IPPU.DoubleHeightPixels   = true;
-			GFX.Pitch                 = GFX.RealPitch * 2;
-			GFX.PPL                   = GFX.RealPitch;
-			GFX.PPLx2                 = GFX.RealPitch;
-
-			/* The game has switched from non-interlaced to interlaced mode part way down the screen. Scale everything. */
-			for (y = (int32_t) GFX.StartY - 1; y >= 0; y--)
-			{
-				/* memmove converted: Same malloc, different addresses, and identical addresses at line 0 [Neb] */
-				memcpy(GFX.Screen + y * 2 * GFX.RealPitch, GFX.Screen + y * GFX.RealPitch, GFX.RealPitch);
-				/* memmove converted: Same malloc, different addresses [Neb] */
-				memcpy(GFX.Screen + (y * 2 + 1) * GFX.RealPitch, GFX.Screen + y * GFX.RealPitch, GFX.RealPitch);
-			}
+			int32_t   x;
+			uint16_t* p = (uint16_t*) (GFX.Screen + y * GFX.RealPitch) + 255;
+			uint16_t* q = (uint16_t*) p + 255;
+
+			for (x = 255; x >= 0; x--, p--, q -= 2)
+				q[0] = q[1] = p[0];
 		}
 	}
 
-	black = BLACK | (BLACK << 16);
-
-	if (GFX.Pseudo)
+	if (rescale & RESCALE_HEIGHT) /* The game has switched from non-interlaced to interlaced mode part way down the screen. Scale everything. */
 	{
-		GFX.r2131 = 0x5f;
-		GFX.r212c &= (Memory.FillRAM[0x212d] | 0xf0);
-		GFX.r212d |= (Memory.FillRAM[0x212c] & 0x0f);
-		GFX.r2130 |= 2;
+		int32_t y;
+
+		for (y = (int32_t) GFX.StartY - 1; y >= 0; y--)
+		{
+			/* memmove converted: Same malloc, different addresses, and identical addresses at line 0 [Neb] */
+			memcpy(GFX.Screen + y * 2 * GFX.RealPitch, GFX.Screen + y * GFX.RealPitch, GFX.RealPitch);
+			/* memmove converted: Same malloc, different addresses [Neb] */
+			memcpy(GFX.Screen + (y * 2 + 1) * GFX.RealPitch, GFX.Screen + y * GFX.RealPitch, GFX.RealPitch);
+		}
 	}
+	black = BLACK | (BLACK << 16);
 
 	if (!PPU.ForcedBlanking && ADD_OR_SUB_ON_ANYTHING && (GFX.r2130 & 0x30) != 0x30 && !((GFX.r2130 & 0x30) == 0x10 && IPPU.Clip[1].Count[5] == 0))
 	{
@@ -3267,5 +3600,27 @@ void UpdateScreen()
 
 	/* Double the height of the pixels just drawn */
 	FIX_INTERLACE(GFX.Screen, false, GFX.ZBuffer);
+}
+
+void UpdateScreen()
+{
+	uint8_t rescale;
+	PERF_START(PERF_UPDATE_SCREEN);
+	rescale = PrepareScreenUpdate();
+	PPU.RangeTimeOver |= GFX.OBJLines[GFX.EndY].RTOFlags;
+
+	if (!IPPU.SkipScreen)
+	{
+#ifdef THREADED_RENDER
+		if (RenderThread)
+			QueueScreenUpdate(rescale);
+		else
+#endif
+			DrawScreenUpdate(rescale);
+
+		PERF_COUNT(PERF_SCANLINES, GFX.EndY + 1 - GFX.StartY);
+	}
+
 	IPPU.PreviousLine = IPPU.CurrentLine;
+	PERF_STOP(PERF_UPDATE_SCREEN);
 }
@@ -7,16 +7,33 @@
 
 #include <retro_inline.h>
 
+/* SSE2 is part of every x86-64 host, and of the 32 bit ones that are built for it */
+#if !defined(MSB_FIRST) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define GFX_SSE2
+
+	#if USE_RGB565
+		#define COLOUR_MATH_SSE2
+	#endif
+#endif
+
 void StartScreenRefresh();
 void DrawScanLine(uint8_t Line);
 void EndScreenRefresh();
 void SetupOBJ();
 void UpdateScreen();
+void DrawScreenUpdate(uint8_t rescale);
 void RenderLine(uint8_t line);
 void BuildDirectColourMaps();
+bool InitGFXTables();
+void DeinitGFXTables();
 bool InitGFX();
 void DeinitGFX();
 
+/* Lines drawn before the screen switched to hi-res or interlaced output, which a screen update has to scale */
+#define RESCALE_WIDTH  1
+#define RESCALE_HEIGHT 2
+
 typedef struct
 {
 	bool      Pseudo     : 1;
@@ -29,6 +46,7 @@ typedef struct
 	uint8_t   r212d;
 	uint8_t   r2130;
 	uint8_t   r2131;
+	uint8_t   r2133;
 	int32_t   Delta;
 	uint32_t  FixedColour;
 	uint32_t  Mode7Mask;
@@ -52,6 +70,7 @@ typedef struct
 	uint8_t*  SubZBuffer_buffer;
 	uint8_t*  ZBuffer;
 	uint8_t*  ZBuffer_buffer;
+	uint8_t*  VRAM;      /* Memory.VRAM, or the render thread's copy of it */
 	uint16_t* Zero;
 #if !USE_RGB565
 	uint16_t* X2;
@@ -76,7 +95,12 @@ typedef struct
 	} OBJLines[SNES_HEIGHT_EXTENDED];
 } SGFX;
 
-extern SGFX GFX;
+#ifdef MULTI_INSTANCE
+	#define GFX              (*GFXPtr)
+	#define DirectColourMaps (*DirectColourMapsPtr)
+#endif
+
+extern INSTANCE SGFX GFX;
 
 typedef struct
 {
@@ -118,14 +142,29 @@ typedef struct
 	int16_t MatrixD;
 } SLineMatrixData;
 
+/* What the last frame drawn was drawn from, so that a frame that would come out the same can be skipped */
+typedef struct
+{
+	bool            Valid;
+	uint8_t         Registers[32];
+	int32_t         Width;
+	int32_t         Height;
+	uint16_t        CGDATA[256];
+	uint8_t         OAMData[512 + 32];
+	SLineData       Lines[240];
+	SLineMatrixData MatrixLines[240];
+	uint8_t         VRAM[0x10000];
+} SScreenSnapshot;
+
 extern uint32_t even_high[4][16];
 extern uint32_t even_low[4][16];
 extern uint32_t odd_high[4][16];
 extern uint32_t odd_low[4][16];
-extern SBG      BG;
-extern uint16_t DirectColourMaps[8][256];
 extern uint8_t  mul_brightness[16][32];
 
+extern THREAD_LOCAL SBG BG; /* Only used while drawing a layer */
+extern INSTANCE uint16_t DirectColourMaps[8][256];
+
 #define SUB_SCREEN_DEPTH  0
 #define MAIN_SCREEN_DEPTH 32
 
@@ -207,7 +246,119 @@ static INLINE uint16_t COLOR_SUB1_2(uint16_t C1, uint16_t C2)
 	return GFX.Zero[((C1 | RGB_HI_BITS_MASKx2) - (C2 & RGB_REMOVE_LOW_BITS_MASK)) >> 1];
 }
 
+/* The colour math of 8 pixels at once, each in a 16 bit lane. The channels are added and subtracted in place with
+ * saturating or clamped arithmetic, which gives the same results as the functions above. */
+#ifdef COLOUR_MATH_SSE2
+#define MATH_NONE         0
+#define MATH_ADD          1
+#define MATH_ADD1_2       2
+#define MATH_SUB          3
+#define MATH_SUB1_2       4
+#define MATH_FIXED_ADD1_2 5 /* Only with the fixed colour */
+#define MATH_FIXED_SUB1_2 6
+
+static INLINE __m128i SelectSSE2(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static INLINE __m128i ColourAddSSE2(__m128i a, __m128i b)
+{
+	const __m128i red   = _mm_set1_epi16((int16_t) 0xF800);
+	const __m128i green = _mm_set1_epi16(0x07C0);
+	const __m128i blue  = _mm_set1_epi16(0x001F);
+	__m128i r = _mm_and_si128(_mm_adds_epu16(_mm_and_si128(a, red), _mm_and_si128(b, red)), red);
+	__m128i g = _mm_min_epi16(_mm_add_epi16(_mm_and_si128(a, green), _mm_and_si128(b, green)), green);
+	__m128i c = _mm_min_epi16(_mm_add_epi16(_mm_and_si128(a, blue), _mm_and_si128(b, blue)), blue);
+	g = _mm_or_si128(g, _mm_and_si128(_mm_srli_epi16(g, 5), _mm_set1_epi16(0x0020)));
+	return _mm_or_si128(_mm_or_si128(r, g), c);
+}
+
+static INLINE __m128i ColourAdd1_2SSE2(__m128i a, __m128i b)
+{
+	const __m128i low = _mm_set1_epi16(RGB_LOW_BITS_MASK);
+	/* The low bits are cleared, so the rounding of the average never kicks in */
+	return _mm_add_epi16(_mm_avg_epu16(_mm_andnot_si128(low, a), _mm_andnot_si128(low, b)), _mm_and_si128(_mm_and_si128(a, b), low));
+}
+
+static INLINE __m128i ColourSubSSE2(__m128i a, __m128i b)
+{
+	const __m128i red   = _mm_set1_epi16((int16_t) 0xF800);
+	const __m128i green = _mm_set1_epi16(0x07E0);
+	const __m128i blue  = _mm_set1_epi16(0x001F);
+	__m128i r = _mm_subs_epu16(_mm_and_si128(a, red), _mm_and_si128(b, red));
+	__m128i g = _mm_and_si128(_mm_subs_epu16(_mm_and_si128(a, green), _mm_and_si128(b, green)), _mm_set1_epi16(0x07C0));
+	__m128i c = _mm_subs_epu16(_mm_and_si128(a, blue), _mm_and_si128(b, blue));
+	return SelectSSE2(_mm_cmpeq_epi16(b, _mm_setzero_si128()), a, _mm_or_si128(_mm_or_si128(r, g), c));
+}
+
+/* Computes the GFX.Zero index of COLOR_SUB1_2 and clears every channel whose top bit is not set */
+static INLINE __m128i ColourSub1_2SSE2(__m128i a, __m128i b)
+{
+	__m128i x = _mm_sub_epi16(_mm_or_si128(_mm_srli_epi16(a, 1), _mm_set1_epi16((int16_t) (RGB_HI_BITS_MASKx2 >> 1))), _mm_srli_epi16(_mm_andnot_si128(_mm_set1_epi16(RGB_LOW_BITS_MASK), b), 1));
+	__m128i r = _mm_and_si128(_mm_srai_epi16(x, 15), _mm_set1_epi16(0x7800));
+	__m128i g = _mm_and_si128(_mm_srai_epi16(_mm_slli_epi16(x, 5), 15), _mm_set1_epi16(0x03E0));
+	__m128i c = _mm_and_si128(_mm_srai_epi16(_mm_slli_epi16(x, 11), 15), _mm_set1_epi16(0x000F));
+	return _mm_and_si128(x, _mm_or_si128(_mm_or_si128(r, g), c));
+}
+
+/* Blends colours with the fixed colour where the sub screen depth is 1 and, unless only the fixed colour is used, with
+ * the sub screen where it is higher */
+static ALWAYS_INLINE __m128i ColourMathSSE2(__m128i colours, __m128i sub, const uint16_t* SubScreen, uint8_t Op)
+{
+	__m128i fixed = _mm_set1_epi16((int16_t) GFX.FixedColour);
+	__m128i one   = _mm_cmpeq_epi16(sub, _mm_set1_epi16(1));
+	__m128i result;
+
+	switch (Op)
+	{
+		case MATH_NONE:
+			return colours;
+		case MATH_ADD:
+			result = SelectSSE2(one, ColourAddSSE2(colours, fixed), ColourAddSSE2(colours, _mm_loadu_si128((const __m128i*) SubScreen)));
+			break;
+		case MATH_ADD1_2:
+			result = SelectSSE2(one, ColourAddSSE2(colours, fixed), ColourAdd1_2SSE2(colours, _mm_loadu_si128((const __m128i*) SubScreen)));
+			break;
+		case MATH_SUB:
+			result = SelectSSE2(one, ColourSubSSE2(colours, fixed), ColourSubSSE2(colours, _mm_loadu_si128((const __m128i*) SubScreen)));
+			break;
+		case MATH_SUB1_2:
+			result = SelectSSE2(one, ColourSubSSE2(colours, fixed), ColourSub1_2SSE2(colours, _mm_loadu_si128((const __m128i*) SubScreen)));
+			break;
+		case MATH_FIXED_ADD1_2:
+			return SelectSSE2(one, ColourAdd1_2SSE2(colours, fixed), colours);
+		default:
+			return SelectSSE2(one, ColourSub1_2SSE2(colours, fixed), colours);
+	}
+
+	return SelectSSE2(_mm_cmpeq_epi16(sub, _mm_setzero_si128()), colours, result);
+}
+#endif
+
 typedef void (*NormalTileRenderer)(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount);
 typedef void (*ClippedTileRenderer)(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount);
 typedef void (*LargePixelRenderer)(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Pixels, uint32_t StartLine, uint32_t LineCount);
+
+#ifdef MULTI_INSTANCE
+	#define DrawTilePtr             (*DrawTilePtrPtr)
+	#define DrawClippedTilePtr      (*DrawClippedTilePtrPtr)
+	#define DrawHiResTilePtr        (*DrawHiResTilePtrPtr)
+	#define DrawHiResClippedTilePtr (*DrawHiResClippedTilePtrPtr)
+	#define DrawLargePixelPtr       (*DrawLargePixelPtrPtr)
+	#define LineData                (*LineDataPtr)
+	#define LineMatrixData          (*LineMatrixDataPtr)
+	#define Mode7Depths             (*Mode7DepthsPtr)
+	#define ScreenSnapshot          (*ScreenSnapshotPtr)
+#endif
+
+extern INSTANCE NormalTileRenderer  DrawTilePtr;
+extern INSTANCE ClippedTileRenderer DrawClippedTilePtr;
+extern INSTANCE NormalTileRenderer  DrawHiResTilePtr;
+extern INSTANCE ClippedTileRenderer DrawHiResClippedTilePtr;
+extern INSTANCE LargePixelRenderer  DrawLargePixelPtr;
+extern INSTANCE SLineData           LineData[240];
+extern INSTANCE SLineMatrixData     LineMatrixData[240];
+extern INSTANCE uint8_t             Mode7Depths[2];
+extern INSTANCE SScreenSnapshot     ScreenSnapshot;
 #endif
@@ -0,0 +1,343 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <rthreads/rthreads.h>
+
+#include "chisnes.h"
+#include "memmap.h"
+#include "ppu.h"
+#include "gfx.h"
+#include "gfxthread.h"
+#include "tile.h"
+
+/* The PPU state one screen update is drawn from. Only the lines GFX.StartY to GFX.EndY of LineData, LineMatrixData and
+ * GFX.OBJLines are copied, and only the 16 byte VRAM rows that changed since the previous update. */
+typedef struct
+{
+	bool            DirectColourMapsNeedRebuild;
+	uint8_t         Rescale;
+	uint32_t        VRAMRows;
+	SPPU            PPU_;
+	InternalPPU     IPPU_;
+	SGFX            GFX_;
+	SLineData       LineData_[240];
+	SLineMatrixData LineMatrixData_[240];
+	uint16_t        Row[MAX_2BIT_TILES];
+	uint8_t         VRAM[0x10000];
+} SRenderJob;
+
+/* Every worker keeps its own copy of VRAM and the tile caches up to date with every job, but only draws the jobs whose
+ * number modulo the worker count is its own. Their lines never overlap, so the bands are drawn side by side. */
+typedef struct
+{
+	SRenderThread*      Pool;
+	uint32_t            Index;
+	uint32_t            Tail; /* Jobs this worker is done with */
+	bool                DirectColourMapsNeedRebuild;
+	sthread_t*          Thread;
+	SGFX                GFX_;
+	uint8_t             Mode7Depths_[2];
+	uint16_t            DirectColourMaps_[8][256];
+	NormalTileRenderer  DrawTilePtr_;
+	ClippedTileRenderer DrawClippedTilePtr_;
+	NormalTileRenderer  DrawHiResTilePtr_;
+	ClippedTileRenderer DrawHiResClippedTilePtr_;
+	LargePixelRenderer  DrawLargePixelPtr_;
+	uint8_t            (*ConvertTile_)(uint8_t*, uint32_t);
+	uint8_t*            TileCache[3];
+	uint8_t*            TileCached[3];
+	uint8_t             VRAM[0x10000];
+} SRenderWorker;
+
+struct SRenderThread
+{
+	bool           Quit;
+	uint32_t       Head; /* Jobs queued by the emulation thread */
+	uint32_t       Workers;
+	slock_t*       Lock;
+	scond_t*       Queued;
+	scond_t*       Drawn;
+	SRenderWorker* Worker;
+	SRenderJob     Jobs[RENDER_THREAD_JOBS];
+};
+
+INSTANCE SRenderThread* RenderThread;
+
+/* The first job some worker is not done with yet. Called with the lock held. */
+static uint32_t DrawnJobs(SRenderThread* r)
+{
+	uint32_t w, tail = r->Worker[0].Tail;
+
+	for (w = 1; w < r->Workers; w++)
+		if ((int32_t) (r->Worker[w].Tail - tail) < 0)
+			tail = r->Worker[w].Tail;
+
+	return tail;
+}
+
+/* In threaded builds the emulation thread never draws, so its own TileCached[TILE_2BIT] flags are free to record which
+ * VRAM rows the render thread already has. Every VRAM write clears them, as do ResetPPU and loading a state. */
+static uint32_t CopyChangedVRAM(SRenderJob* job)
+{
+	uint8_t* cached = IPPU.TileCached[TILE_2BIT];
+	uint32_t row, rows = 0;
+
+	for (row = 0; row < MAX_2BIT_TILES; row += 8)
+	{
+		uint32_t i;
+		uint64_t flags;
+		memcpy(&flags, cached + row, sizeof(flags));
+
+		if (flags == 0x0101010101010101ULL)
+			continue;
+
+		for (i = row; i < row + 8; i++)
+		{
+			if (cached[i])
+				continue;
+
+			memcpy(job->VRAM + (rows << 4), Memory.VRAM + (i << 4), 16);
+			job->Row[rows++] = (uint16_t) i;
+			cached[i]        = true;
+		}
+	}
+
+	return rows;
+}
+
+void QueueScreenUpdate(uint8_t rescale)
+{
+	SRenderThread* r = RenderThread;
+	SRenderJob*    job;
+	uint32_t       lines;
+
+	slock_lock(r->Lock);
+
+	while (r->Head - DrawnJobs(r) == RENDER_THREAD_JOBS)
+		scond_wait(r->Drawn, r->Lock);
+
+	slock_unlock(r->Lock);
+	job                              = &r->Jobs[r->Head % RENDER_THREAD_JOBS];
+	lines                            = GFX.EndY + 1 - GFX.StartY;
+	job->Rescale                     = rescale;
+	job->DirectColourMapsNeedRebuild = IPPU.DirectColourMapsNeedRebuild;
+	memcpy(&job->PPU_, &PPU, sizeof(SPPU));
+	memcpy(&job->IPPU_, &IPPU, sizeof(InternalPPU));
+	memcpy(&job->GFX_, &GFX, offsetof(SGFX, OBJLines));
+	memcpy(&job->GFX_.OBJLines[GFX.StartY], &GFX.OBJLines[GFX.StartY], lines * sizeof(GFX.OBJLines[0]));
+	memcpy(&job->LineData_[GFX.StartY], &LineData[GFX.StartY], lines * sizeof(SLineData));
+	memcpy(&job->LineMatrixData_[GFX.StartY], &LineMatrixData[GFX.StartY], lines * sizeof(SLineMatrixData));
+	job->VRAMRows = CopyChangedVRAM(job);
+
+	if (job->VRAMRows && GFX.StartY > 0) /* Only the lines after this batch see the change */
+		IPPU.PPUChanged = true;
+
+	/* The render thread rebuilds them from now on */
+	IPPU.DirectColourMapsNeedRebuild = false;
+
+	slock_lock(r->Lock);
+	r->Head++;
+	scond_broadcast(r->Queued);
+	slock_unlock(r->Lock);
+}
+
+void WaitRenderThread()
+{
+	SRenderThread* r = RenderThread;
+
+	if (!r)
+		return;
+
+	slock_lock(r->Lock);
+
+	while (DrawnJobs(r) != r->Head)
+		scond_wait(r->Drawn, r->Lock);
+
+	slock_unlock(r->Lock);
+}
+
+static void UpdateVRAM(SRenderWorker* w, SRenderJob* job)
+{
+	uint32_t i;
+
+	for (i = 0; i < job->VRAMRows; i++)
+	{
+		uint32_t row = job->Row[i];
+		memcpy(w->VRAM + (row << 4), job->VRAM + (i << 4), 16);
+		w->TileCached[TILE_2BIT][row]      = false;
+		w->TileCached[TILE_4BIT][row >> 1] = false;
+		w->TileCached[TILE_8BIT][row >> 2] = false;
+	}
+
+	w->DirectColourMapsNeedRebuild |= job->DirectColourMapsNeedRebuild;
+}
+
+static void DrawJob(SRenderWorker* w, SRenderJob* job)
+{
+	uint32_t lines = job->GFX_.EndY + 1 - job->GFX_.StartY;
+
+	memcpy(&GFX, &job->GFX_, offsetof(SGFX, OBJLines));
+	memcpy(&GFX.OBJLines[GFX.StartY], &job->GFX_.OBJLines[GFX.StartY], lines * sizeof(GFX.OBJLines[0]));
+	GFX.VRAM                               = w->VRAM;
+	job->IPPU_.DirectColourMapsNeedRebuild = w->DirectColourMapsNeedRebuild;
+	job->IPPU_.TileCache[TILE_2BIT]        = w->TileCache[TILE_2BIT];
+	job->IPPU_.TileCache[TILE_4BIT]        = w->TileCache[TILE_4BIT];
+	job->IPPU_.TileCache[TILE_8BIT]        = w->TileCache[TILE_8BIT];
+	job->IPPU_.TileCached[TILE_2BIT]       = w->TileCached[TILE_2BIT];
+	job->IPPU_.TileCached[TILE_4BIT]       = w->TileCached[TILE_4BIT];
+	job->IPPU_.TileCached[TILE_8BIT]       = w->TileCached[TILE_8BIT];
+	PPUPtr                                 = &job->PPU_;
+	IPPUPtr                                = &job->IPPU_;
+	LineDataPtr                            = &job->LineData_;
+	LineMatrixDataPtr                      = &job->LineMatrixData_;
+	DrawScreenUpdate(job->Rescale);
+	w->DirectColourMapsNeedRebuild = job->IPPU_.DirectColourMapsNeedRebuild;
+}
+
+static void RenderThreadLoop(void* data)
+{
+	SRenderWorker* w = (SRenderWorker*) data;
+	SRenderThread* r = w->Pool;
+
+	/* Everything else is bound to the job being drawn */
+	GFXPtr                     = &w->GFX_;
+	Mode7DepthsPtr             = &w->Mode7Depths_;
+	DirectColourMapsPtr        = &w->DirectColourMaps_;
+	DrawTilePtrPtr             = &w->DrawTilePtr_;
+	DrawClippedTilePtrPtr      = &w->DrawClippedTilePtr_;
+	DrawHiResTilePtrPtr        = &w->DrawHiResTilePtr_;
+	DrawHiResClippedTilePtrPtr = &w->DrawHiResClippedTilePtr_;
+	DrawLargePixelPtrPtr       = &w->DrawLargePixelPtr_;
+	ConvertTilePtr             = &w->ConvertTile_;
+	slock_lock(r->Lock);
+
+	while (true)
+	{
+		uint32_t    j = w->Tail;
+		SRenderJob* job;
+
+		while (j == r->Head && !r->Quit)
+			scond_wait(r->Queued, r->Lock);
+
+		if (j == r->Head)
+			break;
+
+		job = &r->Jobs[j % RENDER_THREAD_JOBS];
+
+		/* Scaling the screen to hi-res or interlace rewrites the lines above this band, and in interlace the depth
+		 * buffers are cleared for twice as many lines as are drawn, so the bands before must be finished. Interlace
+		 * lasts until the end of the frame, so the rest of it is drawn one band after another. */
+		if (j % r->Workers == w->Index && (job->Rescale || job->IPPU_.DoubleHeightPixels))
+			while (DrawnJobs(r) != j)
+				scond_wait(r->Drawn, r->Lock);
+
+		slock_unlock(r->Lock);
+		UpdateVRAM(w, job);
+
+		if (j % r->Workers == w->Index)
+			DrawJob(w, job);
+
+		slock_lock(r->Lock);
+		w->Tail++;
+		scond_broadcast(r->Drawn);
+	}
+
+	slock_unlock(r->Lock);
+}
+
+bool InitRenderThread()
+{
+	SRenderThread* r = (SRenderThread*) calloc(1, sizeof(SRenderThread));
+	uint32_t       workers = Settings.RenderThreads;
+	uint32_t       i;
+
+	if (!r)
+		return false;
+
+	if (workers < 1)
+		workers = 1;
+	else if (workers > RENDER_THREAD_WORKERS)
+		workers = RENDER_THREAD_WORKERS;
+
+	r->Worker    = (SRenderWorker*) calloc(workers, sizeof(SRenderWorker));
+	r->Lock      = slock_new();
+	r->Queued    = scond_new();
+	r->Drawn     = scond_new();
+	RenderThread = r;
+
+	if (!r->Worker || !r->Lock || !r->Queued || !r->Drawn)
+	{
+		DeinitRenderThread();
+		return false;
+	}
+
+	for (i = 0; i < workers; i++)
+	{
+		SRenderWorker* w = &r->Worker[i];
+		w->Pool                        = r;
+		w->Index                       = i;
+		w->TileCache[TILE_2BIT]        = (uint8_t*) calloc(MAX_2BIT_TILES, 128);
+		w->TileCache[TILE_4BIT]        = (uint8_t*) calloc(MAX_4BIT_TILES, 128);
+		w->TileCache[TILE_8BIT]        = (uint8_t*) calloc(MAX_8BIT_TILES, 128);
+		w->TileCached[TILE_2BIT]       = (uint8_t*) calloc(MAX_2BIT_TILES, 1);
+		w->TileCached[TILE_4BIT]       = (uint8_t*) calloc(MAX_4BIT_TILES, 1);
+		w->TileCached[TILE_8BIT]       = (uint8_t*) calloc(MAX_8BIT_TILES, 1);
+		w->GFX_                        = GFX;
+		w->DrawTilePtr_                = DrawTilePtr;
+		w->DrawClippedTilePtr_         = DrawClippedTilePtr;
+		w->DrawHiResTilePtr_           = DrawHiResTilePtr;
+		w->DrawHiResClippedTilePtr_    = DrawHiResClippedTilePtr;
+		w->DrawLargePixelPtr_          = DrawLargePixelPtr;
+		w->ConvertTile_                = ConvertTile;
+		w->DirectColourMapsNeedRebuild = true;
+		r->Workers                     = i + 1;
+
+		if (!w->TileCache[TILE_2BIT] || !w->TileCache[TILE_4BIT] || !w->TileCache[TILE_8BIT] || !w->TileCached[TILE_2BIT] || !w->TileCached[TILE_4BIT] || !w->TileCached[TILE_8BIT] || !(w->Thread = sthread_create(RenderThreadLoop, w)))
+		{
+			DeinitRenderThread();
+			return false;
+		}
+	}
+
+	/* Everything the emulation thread drew with its own tile cache so far has to be sent over */
+	memset(IPPU.TileCached[TILE_2BIT], 0, MAX_2BIT_TILES);
+	return true;
+}
+
+void DeinitRenderThread()
+{
+	SRenderThread* r = RenderThread;
+	uint32_t i;
+	int32_t t;
+
+	if (!r)
+		return;
+
+	if (r->Lock && r->Queued)
+	{
+		slock_lock(r->Lock);
+		r->Quit = true;
+		scond_broadcast(r->Queued);
+		slock_unlock(r->Lock);
+	}
+
+	for (i = 0; i < r->Workers; i++)
+	{
+		SRenderWorker* w = &r->Worker[i];
+
+		if (w->Thread)
+			sthread_join(w->Thread);
+
+		for (t = 0; t < 3; t++)
+		{
+			free(w->TileCache[t]);
+			free(w->TileCached[t]);
+		}
+	}
+
+	scond_free(r->Drawn);
+	scond_free(r->Queued);
+	slock_free(r->Lock);
+	free(r->Worker);
+	free(r);
+	RenderThread = NULL;
+}
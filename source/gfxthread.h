@@ -0,0 +1,34 @@
+#ifndef CHIMERASNES_GFXTHREAD_H_
+#define CHIMERASNES_GFXTHREAD_H_
+
+/* Only THREADED_RENDER builds have a render thread. The emulation thread still does everything in a screen update that
+ * the game can observe (see PrepareScreenUpdate), then queues a copy of the PPU state the lines are drawn from and
+ * carries on while the render thread draws them into GFX.Screen. With Settings.RenderThreads above one, consecutive
+ * updates are drawn by different threads, each into its own band of lines. The render threads reach that copy through
+ * their own bindings of the thread-local state pointers, so THREADED_RENDER needs MULTI_INSTANCE. */
+#ifdef THREADED_RENDER
+	#ifndef MULTI_INSTANCE
+		#error "THREADED_RENDER requires MULTI_INSTANCE"
+	#endif
+
+	#include <stdint.h>
+	#include <boolean.h>
+
+	#include "port.h"
+
+	#define RENDER_THREAD_JOBS    16 /* Screen updates that can be queued before the emulation waits */
+	#define RENDER_THREAD_LINES   16 /* Lines rendered per screen update when the game does not force one sooner */
+	#define RENDER_THREAD_WORKERS 8  /* Most render threads Settings.RenderThreads can ask for */
+
+	typedef struct SRenderThread SRenderThread;
+
+	#define RenderThread (*RenderThreadPtr)
+
+	extern INSTANCE SRenderThread* RenderThread;
+
+	bool InitRenderThread();
+	void DeinitRenderThread();
+	void QueueScreenUpdate(uint8_t rescale);
+	void WaitRenderThread();
+#endif
+#endif
@@ -16,72 +16,103 @@
 #include "obc1.h"
 #include "srtc.h"
 #include "bsx.h"
+#include "seta.h"
+#include "tile.h"
 #include "pixform.h"
 
-MainLoopPtr MainLoop;
-SCPUState   CPU;
-SICPU       ICPU;
-
-SAPU        APU;
-SIAPU       IAPU;
-SSoundData  SoundData;
-SEXTState   EXT;
-
-SSettings Settings;
-SDSP0     DSP0;
-SDSP1     DSP1;
-SDSP2     DSP2;
-SDSP3     DSP3;
-SDSP4     DSP4;
-SSA1      SA1;
-SRTCData  RTCData;
-SOBC1     OBC1;
-FXRegs_s  FXRegs;
-FXInfo_s  SuperFX;
-SBSX      BSX;
-
-void    (*SetSETA)(uint32_t, uint8_t);
-uint8_t (*GetSETA)(uint32_t);
+INSTANCE void       (*MainLoop)();
+INSTANCE SCPUState  CPU;
+INSTANCE SICPU      ICPU;
+INSTANCE SCPUBlock* CPUBlocks;
+INSTANCE SIdleLoop  IdleLoop;
+
+INSTANCE SAPU       APU;
+INSTANCE SIAPU      IAPU;
+INSTANCE SSoundData SoundData;
+INSTANCE SEXTState  EXT;
+
+INSTANCE SSettings Settings;
+INSTANCE SDSP0     DSP0;
+INSTANCE SDSP1     DSP1;
+INSTANCE SDSP2     DSP2;
+INSTANCE SDSP3     DSP3;
+INSTANCE SDSP4     DSP4;
+INSTANCE SSA1      SA1;
+INSTANCE SRTCData  RTCData;
+INSTANCE SOBC1     OBC1;
+INSTANCE FXRegs_s  FXRegs;
+INSTANCE FXInfo_s  SuperFX;
+INSTANCE SFXBlock* FXBlocks;
+INSTANCE SBSX      BSX;
+
+INSTANCE void    (*SetSETA)(uint8_t, uint32_t);
+INSTANCE uint8_t (*GetSETA)(uint32_t);
 
 SnesModel  M1SNES = {1, 3, 2};
 SnesModel  M2SNES = {2, 4, 3};
 SnesModel* Model = &M1SNES;
 
-CMemory* MemoryPtr = NULL;
+INSTANCE CMemory* MemoryPtr;
+
+INSTANCE SPPU        PPU;
+INSTANCE InternalPPU IPPU;
 
-SPPU        PPU;
-InternalPPU IPPU;
+INSTANCE uint8_t (*ConvertTile)(uint8_t*, uint32_t);
 
-uint8_t (*ConvertTile)(uint8_t*, uint32_t);
+INSTANCE SDMA DMA[8];
 
-SDMA DMA[8];
+INSTANCE uint8_t* HDMAMemPointers[8];
+INSTANCE uint8_t* HDMABasePointers[8];
 
-uint8_t* HDMAMemPointers[8];
-uint8_t* HDMABasePointers[8];
+INSTANCE SGFX            GFX;
+INSTANCE SLineData       LineData[240];
+INSTANCE SLineMatrixData LineMatrixData[240];
 
-SBG             BG;
-SGFX            GFX;
-SLineData       LineData[240];
-SLineMatrixData LineMatrixData[240];
+INSTANCE uint8_t Mode7Depths[2];
 
-uint8_t Mode7Depths[2];
+INSTANCE SScreenSnapshot ScreenSnapshot;
 
-NormalTileRenderer  DrawTilePtr             = NULL;
-ClippedTileRenderer DrawClippedTilePtr      = NULL;
-NormalTileRenderer  DrawHiResTilePtr        = NULL;
-ClippedTileRenderer DrawHiResClippedTilePtr = NULL;
-LargePixelRenderer  DrawLargePixelPtr       = NULL;
+THREAD_LOCAL SBG BG;
+
+INSTANCE NormalTileRenderer  DrawTilePtr;
+INSTANCE ClippedTileRenderer DrawClippedTilePtr;
+INSTANCE NormalTileRenderer  DrawHiResTilePtr;
+INSTANCE ClippedTileRenderer DrawHiResClippedTilePtr;
+INSTANCE LargePixelRenderer  DrawLargePixelPtr;
 
 uint32_t odd_high[4][16];
 uint32_t odd_low[4][16];
 uint32_t even_high[4][16];
 uint32_t even_low[4][16];
 
-bool finishedFrame = false;
+INSTANCE bool finishedFrame;
+
+#ifdef PERF_TEST
+	struct retro_perf_counter PerfCounters[PERF_COUNTERS] =
+	{
+		{"65c816_instructions", 0, 0, 0, false},
+		{"spc700_instructions", 0, 0, 0, false},
+		{"sa1_instructions", 0, 0, 0, false},
+		{"gsu_instructions", 0, 0, 0, false},
+		{"scanlines_rendered", 0, 0, 0, false},
+		{"tiles_converted", 0, 0, 0, false},
+		{"dma_bytes", 0, 0, 0, false},
+		{"hdma_bytes", 0, 0, 0, false},
+		{"brr_blocks_decoded", 0, 0, 0, false},
+		{"sdd1_bytes_decoded", 0, 0, 0, false},
+		{"spc7110_bytes_decoded", 0, 0, 0, false},
+		{"main_loop", 0, 0, 0, false},
+		{"update_screen", 0, 0, 0, false},
+		{"mix_samples", 0, 0, 0, false},
+		{"fx_emulate", 0, 0, 0, false}
+	};
+
+	struct retro_perf_callback PerfCallback;
+#endif
 
-int32_t  Echo[ECHOBUF];
-int8_t   FilterTaps[8];
-int16_t  Loop[FIRBUF];
+INSTANCE int32_t  Echo[ECHOBUF];
+INSTANCE int8_t   FilterTaps[8];
+INSTANCE int16_t  Loop[FIRBUF];
 uint16_t SignExtend[2] = {0x0000, 0xff00};
 
 int32_t HDMA_ModeByteCounts[8] = {1, 2, 2, 4, 4, 4, 2, 4};
@@ -197,7 +228,7 @@ uint8_t Depths[8][4] =
 	{0,         0,         0,         0}          /* 7 */
 };
 
-uint16_t DirectColourMaps[8][256];
+INSTANCE uint16_t DirectColourMaps[8][256];
 
 uint8_t OpLengthsM0X0[256] =
 {
@@ -304,23 +335,4 @@ uint8_t APUCycleLengths[256] = /* Raw SPC700 instruction cycle lengths */
 	/* f0 */ 2, 8, 4, 5, 4, 5, 5, 6, 3, 4, 5, 4, 2, 2, 4,  3
 };
 
-uint8_t APUCycles[256] = /* Actual data used by CPU emulation, will be scaled by APUReset routine to be relative to the 65c816 instruction lengths. */
-{
-	/*       0, 1, 2, 3, 4, 5, 6, 7, 8, 9, a, b, c, d, e,  f */
-	/* 00 */ 2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 5, 4, 5, 4, 6,  8,
-	/* 10 */ 2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 6, 5, 2, 2, 4,  6,
-	/* 20 */ 2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 5, 4, 5, 4, 5,  4,
-	/* 30 */ 2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 6, 5, 2, 2, 3,  8,
-	/* 40 */ 2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 4, 4, 5, 4, 6,  6,
-	/* 50 */ 2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 4, 5, 2, 2, 4,  3,
-	/* 60 */ 2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 4, 4, 5, 4, 5,  5,
-	/* 70 */ 2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 5, 5, 2, 2, 3,  6,
-	/* 80 */ 2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 5, 4, 5, 2, 4,  5,
-	/* 90 */ 2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 5, 5, 2, 2, 12, 5,
-	/* a0 */ 3, 8, 4, 5, 3, 4, 3, 6, 2, 6, 4, 4, 5, 2, 4,  4,
-	/* b0 */ 2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 5, 5, 2, 2, 3,  4,
-	/* c0 */ 3, 8, 4, 5, 4, 5, 4, 7, 2, 5, 6, 4, 5, 2, 4,  9,
-	/* d0 */ 2, 8, 4, 5, 5, 6, 6, 7, 4, 5, 4, 5, 2, 2, 6,  3,
-	/* e0 */ 2, 8, 4, 5, 3, 4, 3, 6, 2, 4, 5, 3, 4, 3, 4,  3,
-	/* f0 */ 2, 8, 4, 5, 4, 5, 5, 6, 3, 4, 5, 4, 2, 2, 4,  3
-};
+INSTANCE uint8_t APUCycles[256]; /* Scaled by ResetAPU to be relative to the 65c816 cycle lengths */
@@ -21,6 +21,7 @@
 #include "sa1.h"
 #include "dsp.h"
 #include "fxemu.h"
+#include "fxinst.h"
 #include "srtc.h"
 #include "sdd1.h"
 #include "spc7110.h"
@@ -244,8 +245,9 @@ bool InitMemory()
 	IPPU.TileCached[TILE_2BIT] = (uint8_t*) calloc(MAX_2BIT_TILES, 1);
 	IPPU.TileCached[TILE_4BIT] = (uint8_t*) calloc(MAX_4BIT_TILES, 1);
 	IPPU.TileCached[TILE_8BIT] = (uint8_t*) calloc(MAX_8BIT_TILES, 1);
+	CPUBlocks                  = (SCPUBlock*) calloc(CPU_BLOCK_COUNT, sizeof(SCPUBlock));
 
-	if (!MemoryPtr || !IPPU.TileCache[TILE_2BIT] || !IPPU.TileCache[TILE_4BIT] || !IPPU.TileCache[TILE_8BIT] || !IPPU.TileCached[TILE_2BIT] || !IPPU.TileCached[TILE_4BIT] || !IPPU.TileCached[TILE_8BIT])
+	if (!MemoryPtr || !IPPU.TileCache[TILE_2BIT] || !IPPU.TileCache[TILE_4BIT] || !IPPU.TileCache[TILE_8BIT] || !IPPU.TileCached[TILE_2BIT] || !IPPU.TileCached[TILE_4BIT] || !IPPU.TileCached[TILE_8BIT] || !CPUBlocks)
 	{
 		DeinitMemory();
 		return false;
@@ -262,7 +264,11 @@ bool InitMemory()
 void DeinitMemory()
 {
 	free(MemoryPtr);
+	free(CPUBlocks);
+	free(FXBlocks);
 	MemoryPtr = NULL;
+	CPUBlocks = NULL;
+	FXBlocks  = NULL;
 
 	for (int32_t t = 0; t < 2; t++)
 	{
@@ -1045,6 +1051,7 @@ void InitROM()
 		case 0x4332:
 		case 0x4532:
 			Settings.Chip = S_DD1;
+			FlushSDD1Cache();
 			break;
 		case 0xF530:
 			Settings.Chip = ST_018;
@@ -1701,9 +1708,10 @@ void ApplyROMFixes()
 
 	Settings.Shutdown = true;
 
-	/* Disabling a speed-up:
+	/* Disabling the SPC700 and WAI speed-ups:
 	 * Games which spool sound samples between the SNES and sound CPU using
-	 * H-DMA as the sample is playing. */
+	 * H-DMA as the sample is playing. Idle loops on the 65c816 are checked
+	 * one by one, so they are still skipped in these games. */
 	if (match_na("EARTHWORM JIM 2") ||
 	    match_na("PRIMAL RAGE") ||
 	    match_na("CLAY FIGHTER") ||
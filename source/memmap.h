@@ -98,7 +98,11 @@ typedef struct
 	uint8_t* WriteMap[MEMMAP_NUM_BLOCKS];
 } CMemory;
 
-extern CMemory* MemoryPtr;
+#ifdef MULTI_INSTANCE
+	#define MemoryPtr (*MemoryPtrPtr)
+#endif
+
+extern INSTANCE CMemory* MemoryPtr;
 #define Memory (*MemoryPtr)
 
 bool     LoadROM(const struct retro_game_info* game, char* info_buf);
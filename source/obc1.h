@@ -8,7 +8,11 @@ typedef struct
 	uint16_t shift;
 } SOBC1;
 
-extern SOBC1 OBC1;
+#ifdef MULTI_INSTANCE
+	#define OBC1 (*OBC1Ptr)
+#endif
+
+extern INSTANCE SOBC1 OBC1;
 
 uint8_t  GetOBC1(uint16_t Address);
 void     SetOBC1(uint8_t Byte, uint16_t Address);
@@ -0,0 +1,41 @@
+#ifndef CHIMERASNES_PERF_H_
+#define CHIMERASNES_PERF_H_
+
+/* Hot path instrumentation, only built with PERF_TEST=1.
+ * The counters are registered with the frontend through RETRO_ENVIRONMENT_GET_PERF_INTERFACE.
+ * Event counters only accumulate call_cnt, timers also accumulate ticks in total. */
+#ifdef PERF_TEST
+	#include <libretro.h>
+
+	enum
+	{
+		PERF_CPU_OPS,
+		PERF_APU_OPS,
+		PERF_SA1_OPS,
+		PERF_GSU_OPS,
+		PERF_SCANLINES,
+		PERF_CONVERTED_TILES,
+		PERF_DMA_BYTES,
+		PERF_HDMA_BYTES,
+		PERF_BRR_BLOCKS,
+		PERF_SDD1_BYTES,
+		PERF_SPC7110_BYTES,
+		PERF_MAIN_LOOP,
+		PERF_UPDATE_SCREEN,
+		PERF_MIX_SAMPLES,
+		PERF_FX_EMULATE,
+		PERF_COUNTERS
+	};
+
+	extern struct retro_perf_counter  PerfCounters[PERF_COUNTERS];
+	extern struct retro_perf_callback PerfCallback;
+
+	#define PERF_COUNT(c, n) (PerfCounters[c].call_cnt += (n))
+	#define PERF_START(c)    PerfCallback.perf_start(&PerfCounters[c])
+	#define PERF_STOP(c)     PerfCallback.perf_stop(&PerfCounters[c])
+#else
+	#define PERF_COUNT(c, n)
+	#define PERF_START(c)
+	#define PERF_STOP(c)
+#endif
+#endif
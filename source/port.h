@@ -18,6 +18,35 @@
 	#define strncasecmp strnicmp
 #endif
 
+/* With MULTI_INSTANCE, every piece of emulator state is reached through a
+ * thread-local pointer that BindContext() points at the storage of one
+ * context. Each header maps the name of its state to (*namePtr) before
+ * declaring it, which turns the declaration into that of the pointer.
+ * Scratch buffers that never outlive a call are simply THREAD_LOCAL. */
+#ifdef MULTI_INSTANCE
+	#ifdef _MSC_VER
+		#define THREAD_LOCAL __declspec(thread)
+	#else
+		#define THREAD_LOCAL __thread
+	#endif
+
+	#define INSTANCE        THREAD_LOCAL
+	#define STATIC_INSTANCE THREAD_LOCAL
+#else
+	#define THREAD_LOCAL
+	#define INSTANCE
+	#define STATIC_INSTANCE static
+#endif
+
+/* For kernels that take their variant as a constant argument, so that every caller gets its own copy */
+#if defined(__GNUC__)
+	#define ALWAYS_INLINE INLINE __attribute__((always_inline))
+#elif defined(_MSC_VER)
+	#define ALWAYS_INLINE __forceinline
+#else
+	#define ALWAYS_INLINE INLINE
+#endif
+
 #define SLASH_STR  "/"
 #define SLASH_CHAR '/'
 
@@ -13,10 +13,15 @@
 #include "spc7110.h"
 #include "gfx.h"
 
-extern uint8_t* HDMAMemPointers[8];
+#ifdef MULTI_INSTANCE
+	#define justifiers (*justifiersPtr)
+	#define in_bit     (*in_bitPtr)
+	#define last_p1    (*last_p1Ptr)
+#endif
 
-uint32_t justifiers = 0xffff00aa;
-uint8_t in_bit = 0;
+STATIC_INSTANCE uint32_t justifiers;
+STATIC_INSTANCE uint8_t  in_bit;
+STATIC_INSTANCE bool     last_p1;
 
 void LatchCounters(bool force)
 {
@@ -110,6 +115,7 @@ void SetPPU(uint8_t Byte, uint16_t Address)
 		}
 		else if (Settings.Chip == SA_1 && Address >= 0x2200 && Address <= 0x23ff)
 		{
+			SA1CatchUp();
 			SetSA1(Byte, Address);
 			return;
 		}
@@ -614,6 +620,8 @@ void SetPPU(uint8_t Byte, uint16_t Address)
 		case 0x217d:
 		case 0x217e:
 		case 0x217f:
+			APUExecute();
+
 			if (Settings.APUEnabled)
 				APUMainLoop();
 
@@ -669,7 +677,10 @@ uint8_t GetPPU(uint16_t Address)
 		if (Settings.Chip == GSU && Address >= 0x3000 && Address <= 0x32ff)
 			return GetSuperFX(Address);
 		else if (Settings.Chip == SA_1 && Address >= 0x2200)
+		{
+			SA1CatchUp();
 			return GetSA1(Address);
+		}
 		else if (Settings.Chip == S_RTC && Address == 0x2800)
 			return GetSRTC(Address);
 		else if (Address == 0x21c2)
@@ -896,6 +907,7 @@ uint8_t GetPPU(uint16_t Address)
 		case 0x217d:
 		case 0x217e:
 		case 0x217f:
+			APUExecute();
 			IAPU.Executing = Settings.APUEnabled;
 			IAPU.WaitCounter++;
 
@@ -1459,7 +1471,6 @@ uint8_t GetCPU(uint16_t Address)
 		case 0x420f:
 			return ICPU.OpenBus;
 		case 0x4210: /* RDNMI */
-			CPU.WaitPC = CPU.PCAtOpcodeStart;
 			byte = Memory.FillRAM[0x4210];
 			Memory.FillRAM[0x4210] = Model->_5A22;
 			return (byte & 0x80) | (ICPU.OpenBus & 0x70) | Model->_5A22;
@@ -1468,7 +1479,6 @@ uint8_t GetCPU(uint16_t Address)
 			ClearIRQSource(PPU_V_BEAM_IRQ_SOURCE | PPU_H_BEAM_IRQ_SOURCE);
 			return byte | (ICPU.OpenBus & 0x7f);
 		case 0x4212: /* HVBJOY */
-			CPU.WaitPC = CPU.PCAtOpcodeStart;
 			return REGISTER_4212() | (ICPU.OpenBus & 0x3e);
 		case 0x4213: /* RDIO */
 		case 0x4214: /* RDDIVL */
@@ -1615,6 +1625,56 @@ uint8_t GetCPU(uint16_t Address)
 	}
 }
 
+/* Resets the parts of IPPU that follow neither from VRAM nor from the PPU registers */
+static void ResetInternalPPU()
+{
+	int32_t c;
+	IPPU.ColorsChanged        = true;
+	IPPU.HDMA                 = 0;
+	IPPU.OBJChanged           = true;
+	IPPU.RenderThisFrame      = true;
+	IPPU.FrameCount           = 0;
+	IPPU.FirstVRAMRead        = false;
+	IPPU.Interlace            = false;
+	IPPU.DoubleWidthPixels    = false;
+	IPPU.HalfWidthPixels      = false;
+	IPPU.DoubleHeightPixels   = false;
+	IPPU.RenderedScreenWidth  = SNES_WIDTH;
+	IPPU.RenderedScreenHeight = SNES_HEIGHT;
+	IPPU.PreviousLine         = IPPU.CurrentLine = 0;
+
+	if (Settings.ControllerOption == 0)
+		IPPU.Controller = SNES_MAX_CONTROLLER_OPTIONS - 1;
+	else
+		IPPU.Controller = Settings.ControllerOption - 1;
+
+	NextController();
+
+	for (c = 0; c < 2; c++)
+		memset(&IPPU.Clip[c], 0, sizeof(ClipData));
+
+	if (IPPU.Controller == SNES_MOUSE)
+	{
+		ProcessMouse(0);
+		ProcessMouse(1);
+	}
+}
+
+static void ResetInputs()
+{
+	PPU.Joypad1ButtonReadPos                = 0;
+	PPU.Joypad2ButtonReadPos                = 0;
+	PPU.Joypad3ButtonReadPos                = 0;
+	IPPU.Joypads[0] = IPPU.Joypads[1]       = IPPU.Joypads[2] = 0;
+	IPPU.Joypads[3] = IPPU.Joypads[4]       = 0;
+	IPPU.SuperScope                         = 0;
+	IPPU.Mouse[0] = IPPU.Mouse[1]           = 0;
+	IPPU.PrevMouseX[0] = IPPU.PrevMouseX[1] = 256 / 2;
+	IPPU.PrevMouseY[0] = IPPU.PrevMouseY[1] = 224 / 2;
+	justifiers                              = 0xffff00aa;
+	in_bit                                  = 0;
+}
+
 void SoftResetPPU()
 {
 	uint8_t B;
@@ -1715,45 +1775,17 @@ void SoftResetPPU()
 	PPU.RecomputeClipWindows                                        = true;
 	PPU.CGFLIPRead                                                  = false;
 	PPU.Need16x8Multiply                                            = false;
-	IPPU.ColorsChanged                                              = true;
-	IPPU.HDMA                                                       = 0;
-	IPPU.OBJChanged                                                 = true;
-	IPPU.RenderThisFrame                                            = true;
 	IPPU.DirectColourMapsNeedRebuild                                = true;
-	IPPU.FrameCount                                                 = 0;
 	memset(IPPU.TileCached[TILE_2BIT], 0, MAX_2BIT_TILES);
 	memset(IPPU.TileCached[TILE_4BIT], 0, MAX_4BIT_TILES);
 	memset(IPPU.TileCached[TILE_8BIT], 0, MAX_8BIT_TILES);
-	IPPU.FirstVRAMRead                                              = false;
-	IPPU.Interlace                                                  = false;
-	IPPU.DoubleWidthPixels                                          = false;
-	IPPU.HalfWidthPixels                                            = false;
-	IPPU.DoubleHeightPixels                                         = false;
-	IPPU.RenderedScreenWidth                                        = SNES_WIDTH;
-	IPPU.RenderedScreenHeight                                       = SNES_HEIGHT;
 	IPPU.XB                                                         = NULL;
 
 	for (c = 0; c < 256; c++)
 		IPPU.ScreenColors[c] = c;
 
 	FixColourBrightness();
-	IPPU.PreviousLine = IPPU.CurrentLine = 0;
-
-	if (Settings.ControllerOption == 0)
-		IPPU.Controller = SNES_MAX_CONTROLLER_OPTIONS - 1;
-	else
-		IPPU.Controller = Settings.ControllerOption - 1;
-
-	NextController();
-
-	for (c = 0; c < 2; c++)
-		memset(&IPPU.Clip[c], 0, sizeof(ClipData));
-
-	if (IPPU.Controller == SNES_MOUSE)
-	{
-		ProcessMouse(0);
-		ProcessMouse(1);
-	}
+	ResetInternalPPU();
 
 	for (c = 0; c < 0x8000; c += 0x100)
 		memset(Memory.FillRAM + c, c >> 8, 0x100);
@@ -1768,15 +1800,15 @@ void SoftResetPPU()
 void ResetPPU()
 {
 	SoftResetPPU();
-	PPU.Joypad1ButtonReadPos                = 0;
-	PPU.Joypad2ButtonReadPos                = 0;
-	PPU.Joypad3ButtonReadPos                = 0;
-	IPPU.Joypads[0] = IPPU.Joypads[1]       = IPPU.Joypads[2] = 0;
-	IPPU.Joypads[3] = IPPU.Joypads[4]       = 0;
-	IPPU.SuperScope                         = 0;
-	IPPU.Mouse[0] = IPPU.Mouse[1]           = 0;
-	IPPU.PrevMouseX[0] = IPPU.PrevMouseX[1] = 256 / 2;
-	IPPU.PrevMouseY[0] = IPPU.PrevMouseY[1] = 224 / 2;
+	ResetInputs();
+}
+
+/* ResetPPU without the PPU registers, which the state overwrites, and without the tile caches and colours, which only
+ * need to change where VRAM, the palette or the brightness do */
+void ResetPPUForStateLoad()
+{
+	ResetInternalPPU();
+	ResetInputs();
 }
 
 void ProcessMouse(int32_t which1)
@@ -1904,10 +1936,9 @@ void NextController()
 
 void UpdateJustifiers()
 {
-	static bool last_p1;
-	bool        offscreen;
-	int32_t     x, y;
-	uint32_t    buttons;
+	bool     offscreen;
+	int32_t  x, y;
+	uint32_t buttons;
 	in_bit     = 0;
 	justifiers = 0xFFFF00AA;
 	offscreen  = JustifierOffscreen();
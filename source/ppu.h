@@ -42,7 +42,9 @@ typedef struct
 	bool     Interlace                   : 1;
 	bool     OBJChanged                  : 1;
 	bool     RenderThisFrame             : 1;
-	int8_t   _InternalPPU_PAD1           : 7;
+	bool     PPUChanged                  : 1; /* Since the frame started, so it cannot be compared with the last one */
+	bool     SkipScreen                  : 1; /* The frame is the same as the last one drawn, so it is neither drawn nor sent */
+	int8_t   _InternalPPU_PAD1           : 5;
 	int8_t   _InternalPPU_PAD2           : 8;
 	uint8_t  HDMA;
 	uint16_t ScreenColors[256];
@@ -200,6 +202,7 @@ typedef struct
 
 void    UpdateScreen();
 void    ResetPPU();
+void    ResetPPUForStateLoad();
 void    SoftResetPPU();
 void    FixColourBrightness();
 void    SuperFXExec();
@@ -217,9 +220,15 @@ void    ProcessMouse(int32_t which1);
 void    JustifierButtons(uint32_t* justifiers);
 bool    JustifierOffscreen();
 
-extern SDMA        DMA[8];
-extern SPPU        PPU;
-extern InternalPPU IPPU;
+#ifdef MULTI_INSTANCE
+	#define DMA  (*DMAPtr)
+	#define PPU  (*PPUPtr)
+	#define IPPU (*IPPUPtr)
+#endif
+
+extern INSTANCE SDMA        DMA[8];
+extern INSTANCE SPPU        PPU;
+extern INSTANCE InternalPPU IPPU;
 
 #include "memmap.h"
 
@@ -245,6 +254,8 @@ static INLINE void FLUSH_REDRAW()
 {
 	if (IPPU.PreviousLine != IPPU.CurrentLine)
 		UpdateScreen();
+
+	IPPU.PPUChanged = true;
 }
 
 static INLINE void REGISTER_2104(uint8_t byte)
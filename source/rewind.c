@@ -0,0 +1,230 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "rewind.h"
+
+/* An encoded difference is a list of pages, each one a 16 bit page number followed by pairs of an 8 bit count of
+ * unchanged bytes and an 8 bit count of changed bytes, the latter followed by those bytes XORed with the newer state.
+ * The pairs of a page end where the page does, so in the worst case of every other byte changing it takes a little
+ * over one and a half times the page size. */
+#define REWIND_MAX_PAGE_SIZE (2 + (REWIND_PAGE_SIZE / 2 + 1) * 3)
+
+typedef struct
+{
+	size_t Offset;
+	size_t Size;
+} SRewindDelta;
+
+struct SRewind
+{
+	bool          HaveState;
+	uint32_t      Pages;
+	uint32_t      Depth;  /* Differences that can be kept */
+	uint32_t      First;  /* Index in Deltas of the oldest difference */
+	uint32_t      Count;  /* Differences kept */
+	size_t        StateSize;
+	size_t        Size;   /* Of Buffer */
+	size_t        Head;   /* Where in Buffer the next difference goes */
+	uint8_t*      State;  /* The newest state */
+	uint8_t*      Encoded;
+	uint8_t*      Buffer;
+	SRewindDelta* Deltas;
+};
+
+INSTANCE SRewind* Rewind;
+
+static void DropOldestDelta(SRewind* r)
+{
+	r->First = (r->First + 1) % r->Depth;
+	r->Count--;
+}
+
+/* Stores the difference between state and the newest state, updating the latter to match. */
+static size_t EncodeDelta(SRewind* r, const uint8_t* state)
+{
+	uint8_t* out = r->Encoded;
+	uint32_t page;
+
+	for (page = 0; page < r->Pages; page++)
+	{
+		size_t         i   = 0;
+		size_t         len = r->StateSize - page * REWIND_PAGE_SIZE;
+		const uint8_t* a   = state + page * REWIND_PAGE_SIZE;
+		uint8_t*       b   = r->State + page * REWIND_PAGE_SIZE;
+
+		if (len > REWIND_PAGE_SIZE)
+			len = REWIND_PAGE_SIZE;
+
+		if (!memcmp(a, b, len))
+			continue;
+
+		*out++ = (uint8_t) page;
+		*out++ = (uint8_t) (page >> 8);
+
+		while (i < len)
+		{
+			size_t same = 0, changed = 0;
+
+			while (i + same < len && same < 0xff && a[i + same] == b[i + same])
+				same++;
+
+			i += same;
+
+			while (i + changed < len && changed < 0xff && a[i + changed] != b[i + changed])
+				changed++;
+
+			*out++ = (uint8_t) same;
+			*out++ = (uint8_t) changed;
+
+			for (; changed > 0; changed--, i++)
+			{
+				*out++ = a[i] ^ b[i];
+				b[i]   = a[i];
+			}
+		}
+	}
+
+	return out - r->Encoded;
+}
+
+/* Turns the newest state back into the one before it */
+static void ApplyDelta(SRewind* r, const uint8_t* in, size_t size)
+{
+	const uint8_t* end = in + size;
+
+	while (in < end)
+	{
+		uint32_t page = in[0] | (in[1] << 8);
+		uint8_t* b    = r->State + page * REWIND_PAGE_SIZE;
+		size_t   i    = 0;
+		size_t   len  = r->StateSize - page * REWIND_PAGE_SIZE;
+		in           += 2;
+
+		if (len > REWIND_PAGE_SIZE)
+			len = REWIND_PAGE_SIZE;
+
+		while (i < len)
+		{
+			size_t changed;
+			i      += in[0];
+			changed = in[1];
+			in     += 2;
+
+			for (; changed > 0; changed--, i++)
+				b[i] ^= *in++;
+		}
+	}
+}
+
+void PushRewindState(const uint8_t* state)
+{
+	SRewind* r = Rewind;
+	size_t   size;
+
+	if (!r->HaveState)
+	{
+		memcpy(r->State, state, r->StateSize);
+		r->HaveState = true;
+		return;
+	}
+
+	if (!(size = EncodeDelta(r, state)))
+		return;
+
+	if (size > r->Size) /* The history before this state is lost */
+	{
+		r->Count = 0;
+		r->Head  = 0;
+		return;
+	}
+
+	if (r->Head + size > r->Size)
+	{
+		/* Everything past Head is older than everything before it */
+		while (r->Count > 0 && r->Deltas[r->First].Offset >= r->Head)
+			DropOldestDelta(r);
+
+		r->Head = 0;
+	}
+
+	while (r->Count > 0 && (r->Count == r->Depth || (r->Deltas[r->First].Offset < r->Head + size && r->Deltas[r->First].Offset + r->Deltas[r->First].Size > r->Head)))
+		DropOldestDelta(r);
+
+	memcpy(r->Buffer + r->Head, r->Encoded, size);
+	r->Deltas[(r->First + r->Count) % r->Depth].Offset = r->Head;
+	r->Deltas[(r->First + r->Count) % r->Depth].Size   = size;
+	r->Count++;
+	r->Head += size;
+}
+
+/* Copies the newest state to state and forgets it, unless it is the oldest one left */
+bool PopRewindState(uint8_t* state)
+{
+	SRewind* r = Rewind;
+	SRewindDelta* delta;
+
+	if (!r->HaveState)
+		return false;
+
+	memcpy(state, r->State, r->StateSize);
+
+	if (r->Count == 0)
+		return true;
+
+	delta   = &r->Deltas[(r->First + r->Count - 1) % r->Depth];
+	ApplyDelta(r, r->Buffer + delta->Offset, delta->Size);
+	r->Head = delta->Offset;
+	r->Count--;
+	return true;
+}
+
+/* Forgets every state, so that the next one pushed starts a new history */
+void ClearRewind()
+{
+	SRewind* r = Rewind;
+	r->HaveState = false;
+	r->First     = 0;
+	r->Count     = 0;
+	r->Head      = 0;
+}
+
+bool InitRewind(size_t state_size, uint32_t depth)
+{
+	SRewind* r = (SRewind*) calloc(1, sizeof(SRewind));
+
+	if (!r)
+		return false;
+
+	r->Pages     = (uint32_t) ((state_size + REWIND_PAGE_SIZE - 1) / REWIND_PAGE_SIZE);
+	r->Depth     = depth;
+	r->StateSize = state_size;
+	r->Size      = (size_t) depth * REWIND_BYTES_PER_STATE;
+	r->State     = (uint8_t*) malloc(state_size);
+	r->Encoded   = (uint8_t*) malloc(r->Pages * REWIND_MAX_PAGE_SIZE);
+	r->Buffer    = (uint8_t*) malloc(r->Size);
+	r->Deltas    = (SRewindDelta*) calloc(depth, sizeof(SRewindDelta));
+	Rewind       = r;
+
+	if (!r->State || !r->Encoded || !r->Buffer || !r->Deltas)
+	{
+		DeinitRewind();
+		return false;
+	}
+
+	return true;
+}
+
+void DeinitRewind()
+{
+	SRewind* r = Rewind;
+
+	if (!r)
+		return;
+
+	free(r->Deltas);
+	free(r->Buffer);
+	free(r->Encoded);
+	free(r->State);
+	free(r);
+	Rewind = NULL;
+}
@@ -0,0 +1,32 @@
+#ifndef CHIMERASNES_REWIND_H_
+#define CHIMERASNES_REWIND_H_
+
+/* A history of serialized states for rewinding. Only the newest state is kept whole. Every older one is kept as its
+ * difference from the state after it: the 256 byte pages that changed between the two, XORed together and run-length
+ * encoded. Since most of RAM, VRAM, SRAM and the APU RAM is left alone from one frame to the next, that takes a few KB
+ * per frame. The differences go to a ring buffer of a fixed size, which forgets the oldest ones when it runs out of
+ * room or holds as many as it was asked to keep. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <boolean.h>
+
+#include "port.h"
+
+#define REWIND_PAGE_SIZE       256
+#define REWIND_BYTES_PER_STATE 4096 /* Ring buffer space for each state of the requested depth */
+
+typedef struct SRewind SRewind;
+
+#ifdef MULTI_INSTANCE
+	#define Rewind (*RewindPtr)
+#endif
+
+extern INSTANCE SRewind* Rewind;
+
+bool InitRewind(size_t state_size, uint32_t depth);
+void DeinitRewind();
+void PushRewindState(const uint8_t* state);
+bool PopRewindState(uint8_t* state);
+void ClearRewind();
+#endif
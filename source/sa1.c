@@ -16,6 +16,7 @@ void SA1Init()
 	SA1.Flags               = 0;
 	SA1.Executing           = false;
 	SA1.WaitCounter         = 0;
+	SA1.CatchUpSteps        = 0;
 	memset(Memory.FillRAM + 0x2200, 0, 0x200);
 	Memory.FillRAM[0x2200]  = 0x20;
 	Memory.FillRAM[0x2220]  = 0x00;
@@ -148,8 +149,7 @@ uint16_t SA1GetWord(uint32_t address, wrap_t w)
 void SA1SetByte(uint8_t byte, uint32_t address)
 {
 	uint8_t* SetAddress = SA1.WriteMap[(address & 0xffffff) >> MEMMAP_SHIFT];
-	CPU.WaitPC = 0;
-	CPU.WaitCounter = 1;
+	IdleLoop.Clean = false;
 
 	if (SetAddress >= (uint8_t*) MAP_LAST)
 	{
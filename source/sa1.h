@@ -54,6 +54,7 @@ typedef struct
 	SOpcodes*     Opcodes;
 	uint8_t*      Map[MEMMAP_NUM_BLOCKS];
 	uint8_t*      WriteMap[MEMMAP_NUM_BLOCKS];
+	uint32_t      CatchUpSteps; /* SNES CPU instructions not yet run by the SA-1 when it runs in slices */
 } SSA1;
 
 #define SA1CheckIRQ()       (SA1.Registers.PL  & IRQ)
@@ -63,7 +64,12 @@ typedef struct
 #define SA1SetFlags(f)      (SA1.Registers.P.W |=  (f))
 #define SA1ClearFlags(f)    (SA1.Registers.P.W &= ~(f))
 
-extern SSA1     SA1;
+#ifdef MULTI_INSTANCE
+	#define SA1 (*SA1Ptr)
+#endif
+
+extern INSTANCE SSA1 SA1;
+
 extern SOpcodes SA1OpcodesM1X1[256];
 extern SOpcodes SA1OpcodesM1X0[256];
 extern SOpcodes SA1OpcodesM0X1[256];
@@ -82,11 +88,24 @@ uint8_t  GetSA1(uint32_t address);
 void     SetSA1(uint8_t byte, uint32_t address);
 void     SA1Init();
 void     SA1MainLoop();
+void     SA1CatchUp();
 
 #define DMA_IRQ_SOURCE   (1 << 5)
 #define TIMER_IRQ_SOURCE (1 << 6)
 #define SNES_IRQ_SOURCE  (1 << 7)
 
+/* Whether the SNES CPU writing to p could change what the SA-1 sees: I-RAM or BW-RAM */
+static INLINE bool SA1SharesAddress(const uint8_t* p)
+{
+	return (uintptr_t) (p - (Memory.FillRAM + 0x3000)) < 0x800 || (uintptr_t) (p - Memory.SRAM) < sizeof(Memory.SRAM);
+}
+
+/* Stopped or waiting in WAI without an interrupt to take. Only a write from the SNES CPU can wake it up. */
+static INLINE bool SA1Asleep()
+{
+	return !SA1.Executing || (SA1.WaitingForInterrupt && !(SA1.Flags & IRQ_FLAG));
+}
+
 static INLINE void SA1UnpackStatus()
 {
 	SA1.Zero     = !(SA1.Registers.PL & ZERO);
@@ -4,6 +4,8 @@
 #include "cpuexec.h"
 #include "sa1.h"
 
+#undef CPU
+#undef ICPU
 #define CPU                          SA1
 #define ICPU                         SA1
 #define GetByte                      SA1GetByte
@@ -48,7 +50,8 @@
 
 #include "cpuops.c"
 
-void SA1MainLoop()
+/* Runs the SA-1 for the length of one SNES CPU instruction */
+static INLINE void SA1Step()
 {
 	uint8_t Op;
 	SOpcodes* Opcodes;
@@ -96,5 +99,25 @@ void SA1MainLoop()
 
 		SA1.Registers.PCw++;
 		(*Opcodes[Op].Opcode)();
+		PERF_COUNT(PERF_SA1_OPS, 1);
 	}
 }
+
+void SA1MainLoop()
+{
+	SA1Step();
+}
+
+/* When the SA-1 runs in slices, the main loop only counts the SNES CPU instructions and this runs the SA-1 for all of
+ * them at once, before the SNES CPU touches anything the two share and at every scanline event. What the SA-1 does
+ * only changes if the SNES CPU reads I-RAM or BW-RAM while it lags behind, or has to take an interrupt from it. The
+ * rest of a slice is skipped as soon as the SA-1 sleeps in WAI. */
+void SA1CatchUp()
+{
+	uint32_t steps = SA1.CatchUpSteps;
+	SA1.CatchUpSteps = 0;
+
+	/* Only the SNES CPU can wake it up, and it waits for the SA-1 to catch up first */
+	for (; steps > 0 && !SA1Asleep(); steps--)
+		SA1Step();
+}
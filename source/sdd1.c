@@ -1,17 +1,25 @@
+#include <stdlib.h>
+
 #include "chisnes.h"
 #include "memmap.h"
 #include "sdd1.h"
 
-static int32_t  valid_bits;
-static uint16_t in_stream;
-static uint8_t* in_buf;
-static uint8_t  bit_ctr[8];
-static uint8_t  context_states[32];
-static int32_t  context_MPS[32];
-static int32_t  bitplane_type;
-static int32_t  high_context_bits;
-static int32_t  low_context_bits;
-static int32_t  prev_bits[8];
+#ifdef MULTI_INSTANCE
+	#define SDD1Cache (*SDD1CachePtr)
+#endif
+
+STATIC_INSTANCE SSDD1Cache SDD1Cache;
+
+static THREAD_LOCAL int32_t  valid_bits;
+static THREAD_LOCAL uint16_t in_stream;
+static THREAD_LOCAL uint8_t* in_buf;
+static THREAD_LOCAL uint8_t  bit_ctr[8];
+static THREAD_LOCAL uint8_t  context_states[32];
+static THREAD_LOCAL int32_t  context_MPS[32];
+static THREAD_LOCAL int32_t  bitplane_type;
+static THREAD_LOCAL int32_t  high_context_bits;
+static THREAD_LOCAL int32_t  low_context_bits;
+static THREAD_LOCAL int32_t  prev_bits[8];
 
 static struct
 {
@@ -95,6 +103,28 @@ void ResetSDD1()
 	}
 }
 
+void DeinitSDD1()
+{
+	FlushSDD1Cache();
+}
+
+static void FreeSDD1CacheEntry(SSDD1CacheEntry* e)
+{
+	free(e->Out);
+	SDD1Cache.Bytes -= e->Length;
+	e->In = e->Out = NULL;
+	e->Length = 0;
+	e->LastUse = 0;
+}
+
+void FlushSDD1Cache()
+{
+	int32_t i;
+
+	for (i = 0; i < SDD1_CACHE_ENTRIES; i++)
+		FreeSDD1CacheEntry(&SDD1Cache.Entries[i]);
+}
+
 static INLINE uint8_t GetCodeword(int32_t bits)
 {
 	uint8_t tmp;
@@ -307,3 +337,60 @@ void SDD1_decompress(uint8_t* out, uint8_t* in, int32_t len)
 			break;
 	}
 }
+
+/* Games DMA the same packets over and over, so the output is kept in a small LRU cache keyed by where the packet is
+ * in ROM. That address already takes the bank mapping into account. Returns NULL if there is no memory for it. */
+uint8_t* SDD1_GetDecompressed(uint8_t* in, int32_t len)
+{
+	SSDD1CacheEntry* e = NULL;
+	int32_t i;
+
+	if (len == 0)
+		len = 0x10000;
+
+	for (i = 0; i < SDD1_CACHE_ENTRIES; i++)
+	{
+		if (SDD1Cache.Entries[i].In == in)
+		{
+			e = &SDD1Cache.Entries[i];
+			break;
+		}
+	}
+
+	if (e && e->Length >= len)
+	{
+		e->LastUse = ++SDD1Cache.Clock;
+		return e->Out;
+	}
+
+	if (e) /* Longer than before */
+		FreeSDD1CacheEntry(e);
+
+	while (!e || SDD1Cache.Bytes + len > SDD1_CACHE_BYTES)
+	{
+		SSDD1CacheEntry* lru = NULL;
+
+		for (i = 0; i < SDD1_CACHE_ENTRIES; i++)
+			if (&SDD1Cache.Entries[i] != e && (!lru || SDD1Cache.Entries[i].LastUse < lru->LastUse))
+				lru = &SDD1Cache.Entries[i];
+
+		if (e && !lru->Out)
+			break;
+
+		FreeSDD1CacheEntry(lru);
+
+		if (!e)
+			e = lru;
+	}
+
+	if (!(e->Out = (uint8_t*) malloc(len)))
+		return NULL;
+
+	SDD1_decompress(e->Out, in, len);
+	PERF_COUNT(PERF_SDD1_BYTES, len);
+	e->In = in;
+	e->Length = len;
+	e->LastUse = ++SDD1Cache.Clock;
+	SDD1Cache.Bytes += len;
+	return e->Out;
+}
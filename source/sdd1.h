@@ -1,7 +1,30 @@
 #ifndef CHIMERASNES_SDD1_H_
 #define CHIMERASNES_SDD1_H_
 
-void SetSDD1MemoryMap(uint32_t bank, uint32_t value);
-void ResetSDD1();
-void SDD1_decompress(uint8_t* out, uint8_t* in, int32_t output_length);
+#define SDD1_CACHE_ENTRIES 64
+#define SDD1_CACHE_BYTES   (2 * 1024 * 1024) /* Decompressed data kept at most */
+
+/* The output of one packet. A packet decompresses the same way whatever its length, so the entry also serves any
+ * shorter transfer from the same place. */
+typedef struct
+{
+	uint8_t* In;      /* Compressed data in ROM, NULL if unused */
+	uint8_t* Out;
+	int32_t  Length;  /* Of Out */
+	uint32_t LastUse;
+} SSDD1CacheEntry;
+
+typedef struct
+{
+	SSDD1CacheEntry Entries[SDD1_CACHE_ENTRIES];
+	uint32_t        Clock;
+	uint32_t        Bytes; /* Held by all the entries */
+} SSDD1Cache;
+
+void     SetSDD1MemoryMap(uint32_t bank, uint32_t value);
+void     ResetSDD1();
+void     DeinitSDD1();
+void     FlushSDD1Cache(); /* Must be called whenever the contents of ROM change */
+void     SDD1_decompress(uint8_t* out, uint8_t* in, int32_t output_length);
+uint8_t* SDD1_GetDecompressed(uint8_t* in, int32_t output_length);
 #endif
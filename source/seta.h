@@ -8,8 +8,13 @@ void    NullSet(uint8_t Byte, uint32_t Address);
 uint8_t GetST010(uint32_t Address);
 void    SetST010(uint8_t Byte, uint32_t Address);
 
-extern void    (*SetSETA)(uint8_t, uint32_t);
-extern uint8_t (*GetSETA)(uint32_t);
+#ifdef MULTI_INSTANCE
+	#define SetSETA (*SetSETAPtr)
+	#define GetSETA (*GetSETAPtr)
+#endif
+
+extern INSTANCE void    (*SetSETA)(uint8_t, uint32_t);
+extern INSTANCE uint8_t (*GetSETA)(uint32_t);
 
 typedef struct
 {
@@ -20,4 +25,10 @@ typedef struct
 	uint8_t input_params[16];
 	uint8_t output_params[16];
 } SST010;
+
+#ifdef MULTI_INSTANCE
+	#define ST010 (*ST010Ptr)
+#endif
+
+extern INSTANCE SST010 ST010;
 #endif
@@ -2,7 +2,7 @@
 #include "memmap.h"
 #include "seta.h"
 
-SST010 ST010;
+INSTANCE SST010 ST010;
 
 static const int16_t ST010_M7Scale[176] = /* Mode 7 scaling constants for all raster lines */
 {
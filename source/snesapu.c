@@ -7,6 +7,11 @@
 #include "snesapu.h"
 #include "soundux.h"
 
+#if !defined(MSB_FIRST) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define DSP_SSE2
+#endif
+
 /* Envelope mode masks */
 #define E_TYPE 0x01 /* Type of adj: Constant(1/64 or 1/256) / Exp.(255/256) */
 #define E_DIR 0x02 /* Direction: Decrease / Increase */
@@ -40,42 +45,7 @@
 #define D_MIN 0 /* Minimum envelope value */
 
 #define DSP_SIZE 2
-
-typedef struct
-{
-	/* Waveform */
-	uint8_t  bHdr;      /* Block Header for current block */
-	uint8_t  mFlg;      /* Mixing flags (see MixF) */
-	uint16_t bCur;      /* -> current block */
-	uint16_t bMixStart; /* -> start block */
-	uint16_t bStart;    /* -> start block */
-
-	/* Envelope */
-	int32_t  eAdj;      /* Amount to adjust envelope height */
-	int32_t  eDest;     /* Envelope Destination */
-	int32_t  eVal;      /* Current envelope value */
-	uint32_t eDec;      /* Pitch Decimal (.16) */
-	uint32_t eRate;     /* Rate of envelope adjustment (16.16) */
-	uint8_t  eMode;     /* [3-0] Current mode (see EnvM) ; [6-4] ADSR mode to switch into from Gain ; [7] Envelope is idle */
-	uint8_t  eRIdx;     /* Index in RateTab (0-31) */
-
-	int8_t   _VoiceMix_PAD1 : 8;
-
-	/* Samples */
-	int8_t sIdx;        /* -> current sample in sBuf */
-	int32_t sP1;        /* Last sample decompressed (prev1) */
-	int32_t sP2;        /* Second to last sample (prev2) */
-	int16_t sBuf[32];   /* 32 + 32 bytes for decompressed sample blocks */
-
-	/* Mixing */
-	int32_t  mChnL;     /* Channel Volume (-24.7) */
-	int32_t  mChnR;     /* Channel Volume (-24.7) */
-	int32_t  mOut;      /* Last sample output before chn vol (used forpitch mod) */
-	uint32_t mDec;      /* Pitch Decimal (.16) (used as delta forinterpolation) */
-	uint32_t mOrgP;     /* Original pitch rate converted from the DSP (16.16) */
-	uint32_t mOrgRate;  /* Pitch Rate before modulation (16.16) */
-	uint32_t mRate;     /* Pitch Rate after modulation (16.16) */
-} VoiceMix;
+#define MIX_BLOCK 128 /* Samples generated for one voice before moving on to the next */
 
 static const struct
 {
@@ -215,49 +185,77 @@ static const uint16_t noiseRateTable[32] =
 	0x0C00, 0x0F00, 0x1400, 0x1800, 0x1E00, 0x2800, 0x3C00, 0x7800
 };
 
-static uint8_t src_buffer[9]; /* Temporary */
+static THREAD_LOCAL uint8_t src_buffer[9]; /* Temporary */
+
+#ifdef DSP_SSE2
+static THREAD_LOCAL int16_t firTaps[8][FIRBUF]; /* FilterTaps lined up with Loop for each position of firCur */
+#endif
+
+#ifdef MULTI_INSTANCE
+	#define mix       (*mixPtr)
+	#define voiceKon  (*voiceKonPtr)
+	#define rateTab   (*rateTabPtr)
+	#define dspRate   (*dspRatePtr)
+	#define pitchAdj  (*pitchAdjPtr)
+	#define volAdj    (*volAdjPtr)
+	#define volMainL  (*volMainLPtr)
+	#define volMainR  (*volMainRPtr)
+	#define volEchoL  (*volEchoLPtr)
+	#define volEchoR  (*volEchoRPtr)
+	#define echoStart (*echoStartPtr)
+	#define echoDel   (*echoDelPtr)
+	#define echoCur   (*echoCurPtr)
+	#define echoFB    (*echoFBPtr)
+	#define echoEnd   (*echoEndPtr)
+	#define nSmp      (*nSmpPtr)
+	#define nDec      (*nDecPtr)
+	#define nRate     (*nRatePtr)
+	#define firCur    (*firCurPtr)
+	#define disEcho   (*disEchoPtr)
+	#define brrCache  (*brrCachePtr)
+#endif
 
 /* Mixing */
-static VoiceMix mix[8];      /* Mixing settings for each voice and waveform playback */
-static uint8_t  voiceKon;    /* Voices that are currently being key on */
-static uint32_t rateTab[32]; /* Update Rate Table */
+STATIC_INSTANCE VoiceMix mix[8];      /* Mixing settings for each voice and waveform playback */
+STATIC_INSTANCE uint8_t  voiceKon;    /* Voices that are currently being key on */
+STATIC_INSTANCE uint32_t rateTab[32]; /* Update Rate Table */
 
 /* DSP Options */
-static int32_t  dspRate;  /* Output sample rate */
-static uint32_t pitchAdj; /* Amount to adjust pitch rates [16.16] */
+STATIC_INSTANCE int32_t  dspRate;  /* Output sample rate */
+STATIC_INSTANCE uint32_t pitchAdj; /* Amount to adjust pitch rates [16.16] */
 
 /* Prototypes for functions that will go in dspDecmp */
 static INLINE void UnpckSrc(uint8_t blk_hdr, uint16_t* xsample_blk, int16_t* output_buf, int32_t* smp_1, int32_t* smp_2);
 
 /* Volume */
-static int32_t volAdj;   /* Amount to adjust main volumes [-15. 16] */
-static int32_t volMainL; /* Main volume */
-static int32_t volMainR;
-static int32_t volEchoL; /* Echo volume */
-static int32_t volEchoR;
+STATIC_INSTANCE int32_t volAdj;   /* Amount to adjust main volumes [-15. 16] */
+STATIC_INSTANCE int32_t volMainL; /* Main volume */
+STATIC_INSTANCE int32_t volMainR;
+STATIC_INSTANCE int32_t volEchoL; /* Echo volume */
+STATIC_INSTANCE int32_t volEchoR;
 
 /* Echo */
-static uint32_t echoStart; /* Echo Start Address */
-static uint32_t echoDel;   /* Size of delay (in bytes) */
-static uint32_t echoCur;   /* Current sample in echo area */
-static int32_t  echoFB;    /* Echo feedback */
+STATIC_INSTANCE uint32_t echoStart; /* Echo Start Address */
+STATIC_INSTANCE uint32_t echoDel;   /* Size of delay (in bytes) */
+STATIC_INSTANCE uint32_t echoCur;   /* Current sample in echo area */
+STATIC_INSTANCE int32_t  echoFB;    /* Echo feedback */
+STATIC_INSTANCE uint32_t echoEnd;   /* Echo written below here since it was last cleared */
 
 /* Noise */
-static int32_t nSmp;  /* Current Noise sample */
-static int16_t nDec;  /* Noise accumulator [.32] (>= 1 generate a new sample) */
-static int16_t nRate; /* Noise sample rate reciprocal [.32] */
+STATIC_INSTANCE int32_t nSmp;  /* Current Noise sample */
+STATIC_INSTANCE int16_t nDec;  /* Noise accumulator [.32] (>= 1 generate a new sample) */
+STATIC_INSTANCE int16_t nRate; /* Noise sample rate reciprocal [.32] */
 
 /* Echo filtering */
-static uint8_t firCur;  /* Index of the first sample to feed into the filter */
-static uint8_t disEcho; /* 0 if echo is enabled */
+STATIC_INSTANCE uint8_t firCur;  /* Index of the first sample to feed into the filter */
+STATIC_INSTANCE uint8_t disEcho; /* 0 if echo is enabled */
 
-/* Storage buffers */
-extern int32_t Echo[ECHOBUF];
-extern int16_t Loop[FIRBUF];
-extern int8_t  FilterTaps[8];
+/* Sample decompression */
+STATIC_INSTANCE SBRRBlock brrCache[BRR_CACHE_SIZE]; /* Decoded blocks, checked against APU RAM before use */
 
 /* Other */
 static int32_t SAtoEMode[256]; /* Used for converting envelope mode flags to Snes9x's enum */
+static bool    tabsBuilt;
 
 static INLINE void APUTimerPulse()
 {
@@ -442,24 +440,12 @@ static INLINE void InitReg(int32_t reg, uint8_t val)
 		(*dspRegs[reg])(i, val);
 }
 
-void InitAPUDSP()
+void InitAPUDSPTables() /* Build the lookup tables that are shared by every context */
 {
 	int32_t i, c;
 
-	/* Reset values so SetDSPOpt will create new ones */
-	dspRate = -1;
-	disEcho = 0;
-
-	for (i = 0; i < 8; i++) /* Erase all mixer settings */
-		memset(mix + i, 0, sizeof(VoiceMix));
-
-	for (i = 0; i < 8; i++) /* Set pointers to reasonable default values. Otherwise savestates cause SEGVs! */
-	{
-		mix[i].sIdx = 0;
-		mix[i].bStart = DSPGetSrc(i);
-		mix[i].bMixStart = mix[i].bStart;
-		mix[i].bCur = DSPGetSrc(i);
-	}
+	if (tabsBuilt)
+		return;
 
 	for (i = 0; i < 13; i++) /* Build a look-up table for all possible expanded values in a BRR block. Range 0-12 */
 		for (c = 0; c < 16; c++)
@@ -499,6 +485,49 @@ void InitAPUDSP()
 	SAtoEMode[E_INC   | E_IDLE] = SOUND_GAIN;
 	SAtoEMode[E_BENT  | E_IDLE] = SOUND_GAIN;
 	SAtoEMode[E_REL   | E_IDLE] = SOUND_GAIN;
+	tabsBuilt = true;
+}
+
+void InitAPUDSP()
+{
+	int32_t i;
+
+	InitAPUDSPTables();
+
+	/* Reset values so SetDSPOpt will create new ones */
+	dspRate = -1;
+	disEcho = 0;
+
+	for (i = 0; i < 8; i++) /* Erase all mixer settings */
+		memset(mix + i, 0, sizeof(VoiceMix));
+
+	for (i = 0; i < 8; i++) /* Set pointers to reasonable default values. Otherwise savestates cause SEGVs! */
+	{
+		mix[i].sIdx = 0;
+		mix[i].bStart = DSPGetSrc(i);
+		mix[i].bMixStart = mix[i].bStart;
+		mix[i].bCur = DSPGetSrc(i);
+	}
+}
+
+/* The echo region can move or grow while echoCur still points into the old one, until it wraps */
+static INLINE void GrowEchoEnd()
+{
+	uint32_t end = echoStart + (echoCur + 2 > echoDel ? echoCur + 2 : echoDel);
+
+	if (end > ECHOBUF)
+		end = ECHOBUF;
+
+	if (end > echoEnd)
+		echoEnd = end;
+}
+
+/* Only clears the part of the echo buffer written since the last time, which is usually a small fraction of it */
+void ClearEcho()
+{
+	memset(Echo, 0, sizeof(int32_t) * echoEnd);
+	echoEnd = 0;
+	GrowEchoEnd();
 }
 
 void SetPlaybackRate(int32_t rate)
@@ -541,7 +570,7 @@ void SetPlaybackRate(int32_t rate)
 	InitReg(APU_EDL, APU.DSP[APU_EDL]);
 
 	/* Erase sample buffers */
-	memset(Echo, 0, sizeof(int32_t) * ECHOBUF);
+	ClearEcho();
 	memset(Loop, 0, sizeof(int16_t) * FIRBUF);
 }
 
@@ -588,13 +617,13 @@ void ResetAPUDSP()
 	nDec = nRate = 0;
 	nSmp = 0x4000;
 
-	/* Erase echo region */
-	memset(Echo, 0, sizeof(int32_t) * ECHOBUF);
-
 	/* Reset echo variables */
 	echoStart = echoCur = echoFB = 0;
 	echoDel = 2; /* Delay 1 sample */
 
+	/* Erase echo region */
+	ClearEcho();
+
 	/* Echo filter */
 	memset(Loop, 0, sizeof(int16_t) * FIRBUF); /* Erase filter memory */
 	memset(FilterTaps, 0, sizeof(int8_t) * 8); /* Reset filter coefficients */
@@ -604,6 +633,13 @@ void ResetAPUDSP()
 
 	/* Disable voices */
 	voiceKon = 0;
+	DecacheSamples();
+}
+
+/* Loading a state does not need to call this, since every block is compared with APU RAM before it is used */
+void DecacheSamples()
+{
+	memset(brrCache, 0, sizeof(brrCache));
 }
 
 static INLINE void ChkStartSrc(int32_t i)
@@ -1207,6 +1243,8 @@ static void REDl(int32_t _1, uint8_t val)
 		echoDel = 2;
 	else
 		echoDel = ((uint32_t)(val << 4) * dspRate / 1000) << 1;
+
+	GrowEchoEnd();
 }
 
 static void RFCI(int32_t i, uint8_t val)
@@ -1277,6 +1315,7 @@ static void RESA(int32_t _1, uint8_t val)
 {
 	(void) _1;
 	echoStart = (val * 64 * dspRate / SNES_SAMPLE_RATE) << 1;
+	GrowEchoEnd();
 }
 
 static void REndX(int32_t _1, uint8_t _2)
@@ -1310,10 +1349,10 @@ static INLINE void NoiseGen() /* Noise Generator - Generates white noise samples
 
    Pitch modulation in the SNES uses the full 16-bit sample value, not the 8-bit value in OUTX as
    previously believed. */
-static INLINE void PitchMod(int32_t ch)
+static INLINE void PitchMod(int32_t ch, int32_t in)
 {
 	uint64_t r;
-	int32_t t = ((mix[ch - 1].mOut + 32768) * mix[ch].mOrgP) >> 15;
+	int32_t t = ((in + 32768) * mix[ch].mOrgP) >> 15;
 
 	if (t > 0x3FFF)
 		t = 0x3FFF;
@@ -1341,39 +1380,96 @@ static INLINE int32_t GetCurSample(int32_t ch)
 	return cursample << 1;
 }
 
-static INLINE int32_t ProcessSample(int32_t ch)
+/* Generates a block of samples of one voice. The samples are always even and within 17 bits, so out holds them halved
+ * to fit in 16 bits. in holds the samples of the previous voice, for pitch modulation. The registers cannot change
+ * while mixing, so everything that depends on them is looked up once. Returns false if the voice was off. */
+static bool GenerateVoice(int32_t ch, int32_t num, const int32_t* noise, const int16_t* in, int16_t* out)
 {
-	int32_t eVal;
+	int32_t n, eVal;
+	bool pmod  = !!(APU.DSP[APU_PMON] & ~APU.DSP[APU_NON] & ~chs[0].m & chs[ch].m);
+	bool noisy  = !!(APU.DSP[APU_NON] & chs[ch].m);
+
+	if ((APU.DSP[APU_FLG] & APU_SOFT_RESET) && !(mix[ch].mFlg & MFLG_OFF))
+		ChgSilence(ch);
+
+	ChkStartSrc(ch);
 
-	if (!(mix[ch].mFlg & MFLG_END)) /* Is there reproducing sound data? */
+	for (n = 0; n < num && !(mix[ch].mFlg & MFLG_OFF); n++) /* Is the current voice active? */
 	{
-		if (APU.DSP[APU_PMON] & ~APU.DSP[APU_NON] & ~chs[0].m & chs[ch].m) /* Pitch Modulation */
-			PitchMod(ch);
+		if (mix[ch].mFlg & MFLG_END) /* Note this, the noise hears only the length of the sound source data. */
+			mix[ch].mOut = 0;
 		else
-			mix[ch].mRate = mix[ch].mOrgRate;
+		{
+			if (pmod) /* Pitch Modulation */
+				PitchMod(ch, in[n] * 2);
+			else
+				mix[ch].mRate = mix[ch].mOrgRate;
 
-		/* Waveform Resizing */
-		ProcessSrc(ch);
-		eVal = mix[ch].eVal;
+			/* Waveform Resizing */
+			ProcessSrc(ch);
+			eVal = mix[ch].eVal;
 
-		if (eVal > D_ATTACK)
-			eVal = D_ATTACK;
-		else if (eVal < D_MIN)
-			eVal = D_MIN;
+			if (eVal > D_ATTACK)
+				eVal = D_ATTACK;
+			else if (eVal < D_MIN)
+				eVal = D_MIN;
 
-		if (APU.DSP[APU_NON] & chs[ch].m)
-		{
-			mix[ch].mOut = (((int32_t) ((int16_t) (nSmp << 1)) * eVal) >> (E_SHIFT + 7)) & ~1;
-			return mix[ch].mOut;
-		}
-		else
-		{
-			mix[ch].mOut = ((GetCurSample(ch) * eVal) >> (E_SHIFT + 7)) & ~1;
-			return ((GetCurSample(ch) * eVal) >> (E_SHIFT + 7)) & ~1;
+			if (noisy)
+				mix[ch].mOut = (((int32_t) ((int16_t) (noise[n] << 1)) * eVal) >> (E_SHIFT + 7)) & ~1;
+			else
+				mix[ch].mOut = ((GetCurSample(ch) * eVal) >> (E_SHIFT + 7)) & ~1;
 		}
+
+		out[n] = (int16_t) (mix[ch].mOut >> 1);
+		CalcEnv(ch); /* Envelope Calculation */
+	}
+
+	if (n < num)
+	{
+		mix[ch].mOut = 0;
+		memset(out + n, 0, sizeof(int16_t) * (num - n));
+	}
+
+	eVal = mix[ch].eVal >> E_SHIFT;
+
+	if (eVal > 0x7f)
+		eVal = 0x7f;
+	else if (eVal < 0)
+		eVal = 0;
+
+	APU.DSP[chs[ch].o + APU_ENVX] = eVal;
+	APU.DSP[chs[ch].o + APU_OUTX] = mix[ch].mOut >> 8;
+	return n > 0;
+}
+
+/* Adds a block of halved samples of a voice to the left and right channels of a mix */
+static INLINE void AddVoice(int32_t* l, int32_t* r, const int16_t* in, int32_t volL, int32_t volR, int32_t num)
+{
+	int32_t n = 0;
+#ifdef DSP_SSE2
+	/* Doubling the volumes instead of the samples keeps both in 16 bits, so the products are exact */
+	const __m128i vl = _mm_set1_epi16((int16_t) (volL * 2));
+	const __m128i vr = _mm_set1_epi16((int16_t) (volR * 2));
+
+	for (; n + 8 <= num; n += 8)
+	{
+		__m128i s  = _mm_loadu_si128((const __m128i*) (in + n));
+		__m128i lo = _mm_mullo_epi16(s, vl);
+		__m128i hi = _mm_mulhi_epi16(s, vl);
+		_mm_storeu_si128((__m128i*) (l + n),     _mm_add_epi32(_mm_loadu_si128((const __m128i*) (l + n)),     _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 7)));
+		_mm_storeu_si128((__m128i*) (l + n + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i*) (l + n + 4)), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 7)));
+		lo = _mm_mullo_epi16(s, vr);
+		hi = _mm_mulhi_epi16(s, vr);
+		_mm_storeu_si128((__m128i*) (r + n),     _mm_add_epi32(_mm_loadu_si128((const __m128i*) (r + n)),     _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 7)));
+		_mm_storeu_si128((__m128i*) (r + n + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i*) (r + n + 4)), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 7)));
+	}
+#endif
+
+	for (; n < num; n++)
+	{
+		l[n] += (in[n] * 2 * volL) >> 7;
+		r[n] += (in[n] * 2 * volR) >> 7;
 	}
-	else /* Note this, the noise hears only the length of the sound source data. */
-		return mix[ch].mOut = 0;
 }
 
 /* Finite Impulse Response Echo Filter - Filters the echo using an eight tap FIR filter:
@@ -1397,6 +1493,39 @@ static INLINE int32_t ProcessSample(int32_t ch)
  * this method really only works if the output rate is a multiple of 32k. In order to get accurate
  * results, some sort of interpolation method needs to be introduced. I went the cheap route and used
  * linear interpolation. */
+#ifdef DSP_SSE2
+/* Lines up the taps with the samples in Loop, so that the whole filter is one dot product wherever firCur is */
+static INLINE void SetupFIRFilter()
+{
+	int32_t k, j;
+
+	for (k = 0; k < 8; k++)
+	{
+		for (j = 0; j < 8; j++)
+			firTaps[k][(j << 1) + 0] = firTaps[k][(j << 1) + 1] = FilterTaps[(k - j) & 7];
+	}
+}
+
+static INLINE void FIRFilter(int32_t* l, int32_t* r)
+{
+	const int16_t* taps = firTaps[firCur >> 1];
+	__m128i s0  = _mm_loadu_si128((const __m128i*) Loop);
+	__m128i s1  = _mm_loadu_si128((const __m128i*) (Loop + 8));
+	__m128i t0  = _mm_loadu_si128((const __m128i*) taps);
+	__m128i t1  = _mm_loadu_si128((const __m128i*) (taps + 8));
+	__m128i lo0 = _mm_mullo_epi16(s0, t0);
+	__m128i hi0 = _mm_mulhi_epi16(s0, t0);
+	__m128i lo1 = _mm_mullo_epi16(s1, t1);
+	__m128i hi1 = _mm_mulhi_epi16(s1, t1);
+
+	/* Every product is shifted on its own, as in the scalar filter, before the left and right ones are summed */
+	__m128i sum = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo0, hi0), 6), _mm_srai_epi32(_mm_unpackhi_epi16(lo0, hi0), 6)),
+	                            _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo1, hi1), 6), _mm_srai_epi32(_mm_unpackhi_epi16(lo1, hi1), 6)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	*l  = _mm_cvtsi128_si32(sum);
+	*r  = _mm_cvtsi128_si32(_mm_srli_si128(sum, 4));
+}
+#else
 static INLINE void FIRFilter(int32_t* l, int32_t* r)
 {
 	/* Reset decimal overflow, so filtering is consistent */
@@ -1411,6 +1540,7 @@ static INLINE void FIRFilter(int32_t* l, int32_t* r)
 		fi = (fi - 2) & (FIRBUF - 2);
 	}
 }
+#endif
 
 static INLINE void ECHOFilter(int32_t* l, int32_t* r, int32_t ll, int32_t rr)
 {
@@ -1430,81 +1560,77 @@ static INLINE void ECHOFilter(int32_t* l, int32_t* r, int32_t ll, int32_t rr)
 	echoCur = (echoCur + 2) % echoDel;
 }
 
-void MixSamples(int16_t* pBuf, int32_t num) /* Emulate DSP - Emulates the DSP of the SNES */
+/* Emulate DSP - Emulates the DSP of the SNES. The voices are generated a block at a time, one voice after the other,
+ * which keeps the state of each one in registers and lets the mixing work on whole blocks. Only the echo has to go
+ * sample by sample, since it feeds back into itself. */
+void MixSamples(int16_t* pBuf, int32_t num)
 {
-	int32_t ch, cnt;
+	int32_t ch, cnt, blk;
+	int32_t noise[MIX_BLOCK];
+	int32_t MixL[MIX_BLOCK], MixR[MIX_BLOCK], EchoL[MIX_BLOCK], EchoR[MIX_BLOCK];
+	int16_t voiceOut[2][MIX_BLOCK];
+	PERF_START(PERF_MIX_SAMPLES);
+
+#ifdef DSP_SSE2
+	SetupFIRFilter();
+#endif
 
-	for (cnt = 0; cnt < num; cnt++, pBuf += DSP_SIZE)
+	for (; num > 0; num -= blk)
 	{
+		blk = num < MIX_BLOCK ? num : MIX_BLOCK;
+
 		/* Erase current samples */
-		int32_t MixSampleL = 0, MixSampleR = 0;
-		int32_t EchoSampleL = 0, EchoSampleR = 0;
-		int32_t l, r;
-		NoiseGen(); /* Generate Noise */
+		memset(MixL, 0, sizeof(int32_t) * blk);
+		memset(MixR, 0, sizeof(int32_t) * blk);
+		memset(EchoL, 0, sizeof(int32_t) * blk);
+		memset(EchoR, 0, sizeof(int32_t) * blk);
 
-		for (ch = 0; ch < 8; ch++)
+		for (cnt = 0; cnt < blk; cnt++)
 		{
-			if (APU.DSP[APU_FLG] & APU_SOFT_RESET)
-			{
-				if(!(mix[ch].mFlg & MFLG_OFF))
-					ChgSilence(ch);
-			}
-
-			int32_t eVal;
-			ChkStartSrc(ch);
-
-			if (!(mix[ch].mFlg & MFLG_OFF)) /* Is the current voice active? */
-			{
-				int32_t cursample = ProcessSample(ch);
-
-				if (cursample != 0 && !(mix[ch].mFlg & MFLG_MUTE)) /* Mixing */
-				{
-					MixSampleL += (cursample * mix[ch].mChnL) >> 7; /* Add to master samples */
-					MixSampleR += (cursample * mix[ch].mChnR) >> 7;
-
-					if (APU.DSP[APU_EON] & chs[ch].m) /* Is echo on? */
-					{
-						EchoSampleL += (cursample * mix[ch].mChnL) >> 7;
-						EchoSampleR += (cursample * mix[ch].mChnR) >> 7;
-					}
-				}
+			NoiseGen(); /* Generate Noise */
+			noise[cnt] = nSmp;
+		}
 
-				CalcEnv(ch); /* Envelope Calculation */
-			}
-			else
-				mix[ch].mOut = 0;
+		for (ch = 0; ch < 8; ch++)
+		{
+			const int16_t* in  = voiceOut[(ch & 1) ^ 1];
+			int16_t*       out = voiceOut[ch & 1];
 
-			eVal = mix[ch].eVal >> E_SHIFT;
+			if (!GenerateVoice(ch, blk, noise, in, out) || (mix[ch].mFlg & MFLG_MUTE))
+				continue;
 
-			if (eVal > 0x7f)
-				eVal = 0x7f;
-			else if (eVal < 0)
-				eVal = 0;
+			AddVoice(MixL, MixR, out, mix[ch].mChnL, mix[ch].mChnR, blk); /* Add to master samples */
 
-			APU.DSP[chs[ch].o + APU_ENVX] = eVal;
-			APU.DSP[chs[ch].o + APU_OUTX] = mix[ch].mOut >> 8;
+			if (APU.DSP[APU_EON] & chs[ch].m) /* Is echo on? */
+				AddVoice(EchoL, EchoR, out, mix[ch].mChnL, mix[ch].mChnR, blk);
 		}
 
-		ECHOFilter(&l, &r, EchoSampleL, EchoSampleR);
-
-		if (!(APU.DSP[APU_FLG] & APU_MUTE)) /* Is the DSP not muted? */
+		for (cnt = 0; cnt < blk; cnt++, pBuf += DSP_SIZE)
 		{
-			/* Multiply samples by main volume */
-			MixSampleL = (MixSampleL * volMainL) >> 7;
-			MixSampleR = (MixSampleR * volMainR) >> 7;
+			int32_t l, r;
+			ECHOFilter(&l, &r, EchoL[cnt], EchoR[cnt]);
 
-			if (!(disEcho & DSP_NOECHO))
+			if (!(APU.DSP[APU_FLG] & APU_MUTE)) /* Is the DSP not muted? */
 			{
-				MixSampleL += (l * volEchoL) >> 7;
-				MixSampleR += (r * volEchoR) >> 7;
-			}
+				/* Multiply samples by main volume */
+				int32_t MixSampleL = (MixL[cnt] * volMainL) >> 7;
+				int32_t MixSampleR = (MixR[cnt] * volMainR) >> 7;
+
+				if (!(disEcho & DSP_NOECHO))
+				{
+					MixSampleL += (l * volEchoL) >> 7;
+					MixSampleR += (r * volEchoR) >> 7;
+				}
 
-			pBuf[0] = INT16_CLAMP(MixSampleL);
-			pBuf[1] = INT16_CLAMP(MixSampleR);
+				pBuf[0] = INT16_CLAMP(MixSampleL);
+				pBuf[1] = INT16_CLAMP(MixSampleR);
+			}
+			else /* Clear sound buffer */
+				pBuf[0] = pBuf[1] = 0;
 		}
-		else /* Clear sound buffer */
-			pBuf[0] = pBuf[1] = 0;
 	}
+
+	PERF_STOP(PERF_MIX_SAMPLES);
 }
 
 /* Decompress Sound Source - Decompresses a 9-byte bit-rate reduced block into 16 16-bit samples
@@ -1533,22 +1659,42 @@ static INLINE int32_t UnpckSrcFilter(int32_t f, int32_t p1, int32_t p2)
 	}
 }
 
+/* Looping samples decode the same blocks over and over, so the result is cached by address. Since APU RAM can be
+ * written in too many ways to track, a cached block is only used if its bytes are still the same, and if the samples
+ * before it were too whenever its filter depends on them. */
 static void UnpckSrc(uint8_t blk_hdr, uint16_t* xsample_blk, int16_t* output_buf, int32_t* smp_1, int32_t* smp_2)
 {
 	int32_t i;
-	uint8_t* sample_blk = DSPGetSrcP(*xsample_blk) + 1;
+	uint8_t* src = DSPGetSrcP(*xsample_blk);
+	uint8_t* sample_blk = src + 1;
 	const int* BRR_row = brrTab + (blk_hdr & 0xf0);
 	int32_t f = (blk_hdr & 0x0c) >> 2;
+	SBRRBlock* b = &brrCache[*xsample_blk & (BRR_CACHE_SIZE - 1)];
+
+	if (b->Address == *xsample_blk && !memcmp(b->Data, src, 9) && (f == 0 || (b->P1 == *smp_1 && b->P2 == *smp_2)))
+	{
+		memcpy(output_buf, b->Samples, sizeof(b->Samples));
+		*smp_2 = output_buf[14];
+		*smp_1 = output_buf[15];
+		*xsample_blk += 9;
+		return;
+	}
+
+	b->Address = *xsample_blk;
+	b->P1 = *smp_1;
+	b->P2 = *smp_2;
+	memcpy(b->Data, src, 9);
 	*xsample_blk += 9;
+	PERF_COUNT(PERF_BRR_BLOCKS, 1);
 
 	for (i = 0; i < 8; i++)
 	{
 		*smp_2 = BRR_row[sample_blk[0] >> 4] + UnpckSrcFilter(f, *smp_1, *smp_2);
 		*smp_2 = (int16_t) (INT16_CLAMP(*smp_2) << 1);
-		output_buf[0] = *smp_2;
+		b->Samples[(i << 1) + 0] = output_buf[0] = *smp_2;
 		*smp_1 = BRR_row[sample_blk[0] & 0x0f] + UnpckSrcFilter(f, *smp_2, *smp_1);
 		*smp_1 = (int16_t) (INT16_CLAMP(*smp_1) << 1);
-		output_buf[1] = *smp_1;
+		b->Samples[(i << 1) + 1] = output_buf[1] = *smp_1;
 		sample_blk++;
 		output_buf += 2;
 	}
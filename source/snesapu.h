@@ -18,8 +18,59 @@
 #define FIXED_POINT_REMAINDER 0xffff
 #define FIXED_POINT_SHIFT 16
 
+typedef struct
+{
+	/* Waveform */
+	uint8_t  bHdr;      /* Block Header for current block */
+	uint8_t  mFlg;      /* Mixing flags (see MixF) */
+	uint16_t bCur;      /* -> current block */
+	uint16_t bMixStart; /* -> start block */
+	uint16_t bStart;    /* -> start block */
+
+	/* Envelope */
+	int32_t  eAdj;      /* Amount to adjust envelope height */
+	int32_t  eDest;     /* Envelope Destination */
+	int32_t  eVal;      /* Current envelope value */
+	uint32_t eDec;      /* Pitch Decimal (.16) */
+	uint32_t eRate;     /* Rate of envelope adjustment (16.16) */
+	uint8_t  eMode;     /* [3-0] Current mode (see EnvM) ; [6-4] ADSR mode to switch into from Gain ; [7] Envelope is idle */
+	uint8_t  eRIdx;     /* Index in RateTab (0-31) */
+
+	int8_t   _VoiceMix_PAD1 : 8;
+
+	/* Samples */
+	int8_t sIdx;        /* -> current sample in sBuf */
+	int32_t sP1;        /* Last sample decompressed (prev1) */
+	int32_t sP2;        /* Second to last sample (prev2) */
+	int16_t sBuf[32];   /* 32 + 32 bytes for decompressed sample blocks */
+
+	/* Mixing */
+	int32_t  mChnL;     /* Channel Volume (-24.7) */
+	int32_t  mChnR;     /* Channel Volume (-24.7) */
+	int32_t  mOut;      /* Last sample output before chn vol (used forpitch mod) */
+	uint32_t mDec;      /* Pitch Decimal (.16) (used as delta forinterpolation) */
+	uint32_t mOrgP;     /* Original pitch rate converted from the DSP (16.16) */
+	uint32_t mOrgRate;  /* Pitch Rate before modulation (16.16) */
+	uint32_t mRate;     /* Pitch Rate after modulation (16.16) */
+} VoiceMix;
+
+/* A decoded BRR block. Blocks are 9 bytes apart, which is coprime with the size of the cache, so a sample of up to
+ * 1024 blocks never evicts its own. A cleared entry is valid too, for a block of zeros at address 0. */
+#define BRR_CACHE_SIZE 1024
+
+typedef struct
+{
+	uint16_t Address;     /* Of the block header */
+	uint8_t  Data[9];     /* The block as it was when decoded */
+	int32_t  P1;          /* Last two samples before the block, which only matter to filters 1 to 3 */
+	int32_t  P2;
+	int16_t  Samples[16];
+} SBRRBlock;
+
+void InitAPUDSPTables();
 void InitAPUDSP();
 void ResetAPUDSP();
+void ClearEcho();
 void SetPlaybackRate(int32_t rate);
 void StoreAPUDSP();
 void RestoreAPUDSP();
@@ -3,9 +3,6 @@
 #include "snesapu.h"
 #include "soundux.h"
 
-extern int8_t   FilterTaps[8];
-extern int16_t  Loop[FIRBUF];
-extern int32_t  Echo[ECHOBUF];
 extern uint32_t Z;
 
 void SetEchoEnable(uint8_t byte)
@@ -15,7 +12,7 @@ void SetEchoEnable(uint8_t byte)
 
 	if (byte && !SoundData.echo_enable)
 	{
-		memset(Echo, 0, sizeof(Echo));
+		ClearEcho();
 		memset(Loop, 0, sizeof(Loop));
 	}
 
@@ -81,7 +78,7 @@ void ResetSound(bool full)
 		SoundData.echo_enable = 0;
 		SoundData.echo_write_enabled = 0;
 		SoundData.pitch_mod = 0;
-		memset(Echo, 0, sizeof(Echo));
+		ClearEcho();
 		memset(Loop, 0, sizeof(Loop));
 	}
 }
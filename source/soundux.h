@@ -82,7 +82,17 @@ typedef struct
 	Channel channels[NUM_CHANNELS];
 } SSoundData;
 
-extern SSoundData SoundData;
+#ifdef MULTI_INSTANCE
+	#define SoundData  (*SoundDataPtr)
+	#define Echo       (*EchoPtr)
+	#define FilterTaps (*FilterTapsPtr)
+	#define Loop       (*LoopPtr)
+#endif
+
+extern INSTANCE SSoundData SoundData;
+extern INSTANCE int32_t    Echo[ECHOBUF];
+extern INSTANCE int8_t     FilterTaps[8];
+extern INSTANCE int16_t    Loop[FIRBUF];
 
 void SetEchoFeedback(int32_t echo_feedback);
 void SetEchoEnable(uint8_t byte);
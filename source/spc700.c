@@ -5,14 +5,14 @@
 #include "cpuexec.h"
 #include "apu.h"
 
-int8_t   Int8  = 0;
-int16_t  Int16 = 0;
-int32_t  Int32 = 0;
-uint8_t  W1;
-uint8_t  W2;
-uint8_t  Work8  = 0;
-uint16_t Work16 = 0;
-uint32_t Work32 = 0;
+THREAD_LOCAL int8_t   Int8  = 0;
+THREAD_LOCAL int16_t  Int16 = 0;
+THREAD_LOCAL int32_t  Int32 = 0;
+THREAD_LOCAL uint8_t  W1;
+THREAD_LOCAL uint8_t  W2;
+THREAD_LOCAL uint8_t  Work8  = 0;
+THREAD_LOCAL uint16_t Work16 = 0;
+THREAD_LOCAL uint32_t Work32 = 0;
 
 #define OP1 IAPU.PC[1]
 #define OP2 IAPU.PC[2]
@@ -4,8 +4,8 @@
 #include "spc7110dec.h"
 #include "memmap.h"
 
-SPC7110Regs s7r; /* SPC7110 registers, about 33KB */
-S7RTC rtc_f9; /* FEOEZ (and Shounen Jump no Shou) RTC */
+INSTANCE SPC7110Regs s7r; /* SPC7110 registers, about 33KB */
+INSTANCE S7RTC rtc_f9; /* FEOEZ (and Shounen Jump no Shou) RTC */
 
 void UpdateRTC(); /* S-RTC function hacked to work with the RTC */
 
@@ -416,7 +416,7 @@ void SetSPC7110(uint8_t data, uint16_t Address)
 			uint32_t mode = (Memory.ROM[addr + 0]);
 			uint32_t offset = (Memory.ROM[addr + 1] << 16) + (Memory.ROM[addr + 2] << 8) + (Memory.ROM[addr + 3]);
 			s7r.reg4806 = data;
-			spc7110dec_clear(mode, offset, (s7r.reg4805 + (s7r.reg4806 << 8)) << mode);
+			spc7110dec_clear(mode, offset, (s7r.reg4805 + (s7r.reg4806 << 8)) << mode, s7r.reg4809 + (s7r.reg480A << 8));
 			s7r.reg480C &= 0x7F;
 			break;
 		}
@@ -80,6 +80,11 @@ typedef struct
 	uint32_t DataRomSize;
 } SPC7110Regs;
 
-extern SPC7110Regs s7r;
-extern S7RTC       rtc_f9;
+#ifdef MULTI_INSTANCE
+	#define s7r    (*s7rPtr)
+	#define rtc_f9 (*rtc_f9Ptr)
+#endif
+
+extern INSTANCE SPC7110Regs s7r;
+extern INSTANCE S7RTC       rtc_f9;
 #endif
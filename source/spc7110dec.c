@@ -1,4 +1,5 @@
 #include "memmap.h"
+#include "perf.h"
 #include "spc7110dec.h"
 
 #define SPC7110_DECOMP_BUFFER_SIZE 64 /* must be >= 64, and must be a power of two */
@@ -29,35 +30,130 @@ static const uint8_t mode2_context_table[32][2] = /* { next 0, next 1 } */
 	{31, 31}, {31, 31}, {31, 31}, {31, 31}, {31, 31}, {31, 31}, {31, 31}, {31, 31}
 };
 
-typedef struct
+INSTANCE SPC7110Decomp decomp;
+
+/* Makes state the one at the end of packet p, which may be NULL to decompress into buffer instead */
+static void spc7110dec_switch(SPC7110Packet* p)
+{
+	if (decomp.decoding == p)
+		return;
+
+	if (decomp.decoding)
+		decomp.decoding->state = decomp.state;
+
+	if (p)
+	{
+		decomp.state = p->state;
+		decomp.buffer_rdoffset = 0;
+		decomp.buffer_wroffset = 0;
+		decomp.buffer_length = 0;
+	}
+
+	decomp.decoding = p;
+}
+
+static void spc7110dec_free(SPC7110Packet* p)
+{
+	if (decomp.decoding == p)
+		decomp.decoding = NULL;
+
+	free(p->data);
+	decomp.cache_bytes -= p->size;
+	memset(p, 0, sizeof(SPC7110Packet));
+}
+
+/* Makes room for size bytes in p, forgetting the packets used least recently if needed */
+static bool spc7110dec_grow(SPC7110Packet* p, uint32_t size)
 {
-	uint32_t buffer_length;
-	uint32_t buffer_rdoffset;
-	uint32_t buffer_wroffset;
-	uint32_t mode;
-	uint32_t offset;
-	uint32_t original_mode;
-	uint32_t original_index;
-	uint32_t original_offset;
-	uint32_t read_counter;
-	uint32_t morton16[2][256];
-	uint32_t morton32[4][256];
-	uint8_t* buffer;
-
-	struct
+	uint8_t* data;
+
+	while (decomp.cache_bytes - p->size + size > SPC7110_PACKET_CACHE_BYTES)
 	{
-		uint8_t index;
-		uint8_t invert;
-	} context[32];
-} SPC7110Decomp;
+		SPC7110Packet* lru = NULL;
+		uint32_t i;
+
+		for (i = 0; i < SPC7110_PACKET_ENTRIES; i++)
+			if (decomp.packets[i].data && &decomp.packets[i] != p && &decomp.packets[i] != decomp.packet && (!lru || decomp.packets[i].last_use < lru->last_use))
+				lru = &decomp.packets[i];
+
+		if (!lru)
+			return false;
 
-SPC7110Decomp decomp;
+		spc7110dec_free(lru);
+	}
+
+	if (!(data = (uint8_t*) realloc(p->data, size)))
+		return false;
+
+	decomp.cache_bytes += size - p->size;
+	p->data = data;
+	p->size = size;
+	return true;
+}
+
+/* Decompresses p up to length bytes, or as far as the memory limits allow */
+static void spc7110dec_fill(SPC7110Packet* p, uint32_t length)
+{
+	if (length > SPC7110_PACKET_MAX_BYTES)
+		length = SPC7110_PACKET_MAX_BYTES;
+
+	spc7110dec_switch(p);
+
+	while (p->length < length)
+	{
+		/* A call to the decoder adds less than SPC7110_DECOMP_BUFFER_SIZE bytes */
+		if (p->length + SPC7110_DECOMP_BUFFER_SIZE > p->size)
+		{
+			uint32_t size = p->size ? p->size * 2 : SPC7110_PACKET_CHUNK * 4;
+
+			if (size > SPC7110_PACKET_MAX_BYTES + SPC7110_DECOMP_BUFFER_SIZE)
+				size = SPC7110_PACKET_MAX_BYTES + SPC7110_DECOMP_BUFFER_SIZE;
+
+			if (!spc7110dec_grow(p, size))
+				return;
+		}
+
+		switch (decomp.mode)
+		{
+			case 0:
+				spc7110dec_mode0(false);
+				break;
+			case 1:
+				spc7110dec_mode1(false);
+				break;
+			case 2:
+				spc7110dec_mode2(false);
+				break;
+		}
+
+		for (; decomp.buffer_length > 0; decomp.buffer_length--)
+		{
+			p->data[p->length++] = decomp.buffer[decomp.buffer_rdoffset++];
+			decomp.buffer_rdoffset &= SPC7110_DECOMP_BUFFER_SIZE - 1;
+		}
+	}
+}
 
 uint8_t spc7110dec_read()
 {
 	uint8_t data;
+	SPC7110Packet* p = decomp.packet;
 	decomp.read_counter++;
 
+	if (p)
+	{
+		if (decomp.position >= p->length)
+			spc7110dec_fill(p, p->length + SPC7110_PACKET_CHUNK);
+
+		if (decomp.position < p->length)
+			return p->data[decomp.position++];
+
+		/* Out of room, carry on from the end of it without keeping the output */
+		spc7110dec_switch(p);
+		spc7110dec_switch(NULL);
+		decomp.packet = NULL;
+	}
+
 	if (decomp.buffer_length == 0)
 	{
 		switch (decomp.mode)
@@ -84,6 +180,7 @@ uint8_t spc7110dec_read()
 
 void spc7110dec_write(uint8_t data)
 {
+	PERF_COUNT(PERF_SPC7110_BYTES, 1);
 	decomp.buffer[decomp.buffer_wroffset++] = data;
 	decomp.buffer_wroffset &= SPC7110_DECOMP_BUFFER_SIZE - 1;
 	decomp.buffer_length++;
@@ -98,41 +195,86 @@ uint8_t spc7110dec_dataread()
 	else
 		size = Memory.CalculatedSize - 0x100000;
 
-	while (decomp.offset >= size)
-		decomp.offset -= size;
+	while (decomp.state.offset >= size)
+		decomp.state.offset -= size;
 
-	return Memory.ROM[0x100000 + decomp.offset++];
+	return Memory.ROM[0x100000 + decomp.state.offset++];
 }
 
-void spc7110dec_clear(uint32_t mode, uint32_t offset, uint32_t index)
+/* Starts decompressing the packet at offset, skipping index bytes of its output. The games read the same packets over
+ * and over, so the output of the last few is kept and a game about to read length bytes gets them decompressed ahead. */
+void spc7110dec_clear(uint32_t mode, uint32_t offset, uint32_t index, uint32_t length)
 {
+	SPC7110Packet* p = NULL;
 	uint32_t i;
 	decomp.original_mode = mode;
 	decomp.original_offset = offset;
 	decomp.original_index = index;
 	decomp.mode = mode;
-	decomp.offset = offset;
 	decomp.buffer_rdoffset = 0;
 	decomp.buffer_wroffset = 0;
 	decomp.buffer_length = 0;
+	decomp.packet = NULL;
 
-	for (i = 0; i < 32; i++) /* reset decomp.context states */
+	if (mode <= 2)
 	{
-		decomp.context[i].index = 0;
-		decomp.context[i].invert = 0;
+		for (i = 0; i < SPC7110_PACKET_ENTRIES; i++)
+		{
+			if (decomp.packets[i].valid && decomp.packets[i].mode == mode && decomp.packets[i].offset == offset)
+			{
+				p = &decomp.packets[i];
+				break;
+			}
+		}
 	}
 
-	switch (decomp.mode)
+	if (!p)
 	{
-		case 0:
-			spc7110dec_mode0(true);
-			break;
-		case 1:
-			spc7110dec_mode1(true);
-			break;
-		case 2:
-			spc7110dec_mode2(true);
-			break;
+		if (mode <= 2)
+		{
+			for (i = 0; i < SPC7110_PACKET_ENTRIES; i++)
+				if (!p || decomp.packets[i].last_use < p->last_use)
+					p = &decomp.packets[i];
+
+			spc7110dec_free(p);
+		}
+
+		spc7110dec_switch(p);
+		decomp.state.offset = offset;
+
+		for (i = 0; i < 32; i++) /* reset decomp.context states */
+		{
+			decomp.state.context[i].index = 0;
+			decomp.state.context[i].invert = 0;
+		}
+
+		switch (decomp.mode)
+		{
+			case 0:
+				spc7110dec_mode0(true);
+				break;
+			case 1:
+				spc7110dec_mode1(true);
+				break;
+			case 2:
+				spc7110dec_mode2(true);
+				break;
+		}
+
+		if (p)
+		{
+			p->valid = true;
+			p->mode = mode;
+			p->offset = offset;
+		}
+	}
+
+	if (p)
+	{
+		p->last_use = ++decomp.clock;
+		decomp.packet = p;
+		decomp.position = 0;
+		spc7110dec_fill(p, index + (length ? length : SPC7110_PACKET_CHUNK));
 	}
 
 	while (index--) /* decompress up to requested output data index */
@@ -143,16 +285,13 @@ void spc7110dec_clear(uint32_t mode, uint32_t offset, uint32_t index)
 
 void spc7110dec_mode0(bool init)
 {
-	static uint8_t val, in, span;
-	static int32_t out, inverts, lps, in_count;
-
 	if (init)
 	{
-		out = inverts = lps = 0;
-		span = 0xff;
-		val = spc7110dec_dataread();
-		in = spc7110dec_dataread();
-		in_count = 8;
+		decomp.state.out0 = decomp.state.inverts = decomp.state.lps = 0;
+		decomp.state.span = 0xff;
+		decomp.state.val = spc7110dec_dataread();
+		decomp.state.in = spc7110dec_dataread();
+		decomp.state.in_count = 8;
 		return;
 	}
 
@@ -168,80 +307,76 @@ void spc7110dec_mode0(bool init)
 
 			/* Get decomp.context */
 			uint8_t mask = (1 << (bit & 3)) - 1;
-			uint8_t con = mask + ((inverts & mask) ^ (lps & mask));
+			uint8_t con = mask + ((decomp.state.inverts & mask) ^ (decomp.state.lps & mask));
 
 			if (bit > 3)
 				con += 15;
 
 			/* Get prob and mps */
 			prob = spc7110dec_probability(con);
-			mps = (((out >> 15) & 1) ^ decomp.context[con].invert);
+			mps = (((decomp.state.out0 >> 15) & 1) ^ decomp.state.context[con].invert);
 
 			/* Get bit */
-			if (val <= span - prob) /* mps */
+			if (decomp.state.val <= decomp.state.span - prob) /* mps */
 			{
-				span = span - prob;
-				out = (out << 1) + mps;
+				decomp.state.span = decomp.state.span - prob;
+				decomp.state.out0 = (decomp.state.out0 << 1) + mps;
 				flag_lps = 0;
 			}
 			else /* lps */
 			{
-				val = val - (span - (prob - 1));
-				span = prob - 1;
-				out = (out << 1) + 1 - mps;
+				decomp.state.val = decomp.state.val - (decomp.state.span - (prob - 1));
+				decomp.state.span = prob - 1;
+				decomp.state.out0 = (decomp.state.out0 << 1) + 1 - mps;
 				flag_lps = 1;
 			}
 
-			while (span < 0x7f) /* Renormalize */
+			while (decomp.state.span < 0x7f) /* Renormalize */
 			{
 				shift++;
-				span = (span << 1) + 1;
-				val = (val << 1) + (in >> 7);
-				in <<= 1;
+				decomp.state.span = (decomp.state.span << 1) + 1;
+				decomp.state.val = (decomp.state.val << 1) + (decomp.state.in >> 7);
+				decomp.state.in <<= 1;
 
-				if (--in_count == 0)
+				if (--decomp.state.in_count == 0)
 				{
-					in = spc7110dec_dataread();
-					in_count = 8;
+					decomp.state.in = spc7110dec_dataread();
+					decomp.state.in_count = 8;
 				}
 			}
 
 			/* Update processing info */
-			lps = (lps << 1) + flag_lps;
-			inverts = (inverts << 1) + decomp.context[con].invert;
+			decomp.state.lps = (decomp.state.lps << 1) + flag_lps;
+			decomp.state.inverts = (decomp.state.inverts << 1) + decomp.state.context[con].invert;
 
 			if (flag_lps & spc7110dec_toggle_invert(con)) /* Update context state */
-				decomp.context[con].invert ^= 1;
+				decomp.state.context[con].invert ^= 1;
 
 			if (flag_lps)
-				decomp.context[con].index = spc7110dec_next_lps(con);
+				decomp.state.context[con].index = spc7110dec_next_lps(con);
 			else if (shift)
-				decomp.context[con].index = spc7110dec_next_mps(con);
+				decomp.state.context[con].index = spc7110dec_next_mps(con);
 		}
 
 		/* Save byte */
-		spc7110dec_write(out);
+		spc7110dec_write(decomp.state.out0);
 	}
 }
 
 void spc7110dec_mode1(bool init)
 {
-	static uint32_t pixelorder[4], realorder[4];
-	static uint8_t in, val, span;
-	static int32_t out, inverts, lps, in_count;
-
 	if (init)
 	{
 		uint32_t i;
 
 		for (i = 0; i < 4; i++)
-			pixelorder[i] = i;
+			decomp.state.pixelorder[i] = i;
 
-		out = inverts = lps = 0;
-		span = 0xff;
-		val = spc7110dec_dataread();
-		in = spc7110dec_dataread();
-		in_count = 8;
+		decomp.state.out0 = decomp.state.inverts = decomp.state.lps = 0;
+		decomp.state.span = 0xff;
+		decomp.state.val = spc7110dec_dataread();
+		decomp.state.in = spc7110dec_dataread();
+		decomp.state.in_count = 8;
 		return;
 	}
 
@@ -252,50 +387,50 @@ void spc7110dec_mode1(bool init)
 		for (pixel = 0; pixel < 8; pixel++)
 		{
 			/* Get first symbol decomp.context */
-			uint32_t a = ((out >> (1 * 2)) & 3);
-			uint32_t b = ((out >> (7 * 2)) & 3);
-			uint32_t c = ((out >> (8 * 2)) & 3);
+			uint32_t a = ((decomp.state.out0 >> (1 * 2)) & 3);
+			uint32_t b = ((decomp.state.out0 >> (7 * 2)) & 3);
+			uint32_t c = ((decomp.state.out0 >> (8 * 2)) & 3);
 			uint32_t con = (a == b) ? (b != c) : (b == c) ? 2 : 4 - (a == c);
 			uint32_t bit, m, n;
 
 			for (m = 0; m < 4; m++) /* Update pixel order */
-				if (pixelorder[m] == a)
+				if (decomp.state.pixelorder[m] == a)
 					break;
 
 			for (n = m; n > 0; n--)
-				pixelorder[n] = pixelorder[n - 1];
+				decomp.state.pixelorder[n] = decomp.state.pixelorder[n - 1];
 
-			pixelorder[0] = a;
+			decomp.state.pixelorder[0] = a;
 
 			for (m = 0; m < 4; m++) /* Calculate the real pixel order */
-				realorder[m] = pixelorder[m];
+				decomp.state.realorder[m] = decomp.state.pixelorder[m];
 
 			for (m = 0; m < 4; m++) /* Rotate reference pixel c value to top */
-				if (realorder[m] == c)
+				if (decomp.state.realorder[m] == c)
 					break;
 
 			for (n = m; n > 0; n--)
-				realorder[n] = realorder[n - 1];
+				decomp.state.realorder[n] = decomp.state.realorder[n - 1];
 
-			realorder[0] = c;
+			decomp.state.realorder[0] = c;
 
 			for (m = 0; m < 4; m++) /* Rotate reference pixel b value to top */
-				if (realorder[m] == b)
+				if (decomp.state.realorder[m] == b)
 					break;
 
 			for (n = m; n > 0; n--)
-				realorder[n] = realorder[n - 1];
+				decomp.state.realorder[n] = decomp.state.realorder[n - 1];
 
-			realorder[0] = b;
+			decomp.state.realorder[0] = b;
 
 			for (m = 0; m < 4; m++) /* Rotate reference pixel a value to top */
-				if (realorder[m] == a)
+				if (decomp.state.realorder[m] == a)
 					break;
 
 			for (n = m; n > 0; n--)
-				realorder[n] = realorder[n - 1];
+				decomp.state.realorder[n] = decomp.state.realorder[n - 1];
 
-			realorder[0] = a;
+			decomp.state.realorder[0] = a;
 
 			for (bit = 0; bit < 2; bit++) /* Get 2 symbols */
 			{
@@ -305,55 +440,55 @@ void spc7110dec_mode1(bool init)
 				uint32_t flag_lps;
 
 				/* Get symbol */
-				if (val <= span - prob) /* mps */
+				if (decomp.state.val <= decomp.state.span - prob) /* mps */
 				{
-					span = span - prob;
+					decomp.state.span = decomp.state.span - prob;
 					flag_lps = 0;
 				}
 				else /* lps */
 				{
-					val = val - (span - (prob - 1));
-					span = prob - 1;
+					decomp.state.val = decomp.state.val - (decomp.state.span - (prob - 1));
+					decomp.state.span = prob - 1;
 					flag_lps = 1;
 				}
 
-				while (span < 0x7f) /* Renormalize */
+				while (decomp.state.span < 0x7f) /* Renormalize */
 				{
 					shift++;
-					span = (span << 1) + 1;
-					val = (val << 1) + (in >> 7);
-					in <<= 1;
+					decomp.state.span = (decomp.state.span << 1) + 1;
+					decomp.state.val = (decomp.state.val << 1) + (decomp.state.in >> 7);
+					decomp.state.in <<= 1;
 
-					if (--in_count == 0)
+					if (--decomp.state.in_count == 0)
 					{
-						in = spc7110dec_dataread();
-						in_count = 8;
+						decomp.state.in = spc7110dec_dataread();
+						decomp.state.in_count = 8;
 					}
 				}
 
 				/* Update processing info */
-				lps = (lps << 1) + flag_lps;
-				inverts = (inverts << 1) + decomp.context[con].invert;
+				decomp.state.lps = (decomp.state.lps << 1) + flag_lps;
+				decomp.state.inverts = (decomp.state.inverts << 1) + decomp.state.context[con].invert;
 
 				if (flag_lps & spc7110dec_toggle_invert(con)) /* Update context state */
-					decomp.context[con].invert ^= 1;
+					decomp.state.context[con].invert ^= 1;
 
 				if (flag_lps)
-					decomp.context[con].index = spc7110dec_next_lps(con);
+					decomp.state.context[con].index = spc7110dec_next_lps(con);
 				else if (shift)
-					decomp.context[con].index = spc7110dec_next_mps(con);
+					decomp.state.context[con].index = spc7110dec_next_mps(con);
 
 				/* Get next decomp.context */
-				con = 5 + (con << 1) + ((lps ^ inverts) & 1);
+				con = 5 + (con << 1) + ((decomp.state.lps ^ decomp.state.inverts) & 1);
 			}
 
 			/* Get pixel */
-			b = realorder[(lps ^ inverts) & 3];
-			out = (out << 2) + b;
+			b = decomp.state.realorder[(decomp.state.lps ^ decomp.state.inverts) & 3];
+			decomp.state.out0 = (decomp.state.out0 << 2) + b;
 		}
 
 		/* Turn pixel data into bitplanes */
-		data = spc7110dec_morton_2x8(out);
+		data = spc7110dec_morton_2x8(decomp.state.out0);
 		spc7110dec_write(data >> 8);
 		spc7110dec_write(data >> 0);
 	}
@@ -362,22 +497,18 @@ void spc7110dec_mode1(bool init)
 void spc7110dec_mode2(bool init)
 {
 	uint32_t i;
-	static uint32_t pixelorder[16], realorder[16];
-	static uint8_t bitplanebuffer[16], buffer_index;
-	static uint8_t in, val, span;
-	static int32_t out0, out1, inverts, lps, in_count;
 
 	if (init)
 	{
 		for (i = 0; i < 16; i++)
-			pixelorder[i] = i;
-
-		buffer_index = 0;
-		out0 = out1 = inverts = lps = 0;
-		span = 0xff;
-		val = spc7110dec_dataread();
-		in = spc7110dec_dataread();
-		in_count = 8;
+			decomp.state.pixelorder[i] = i;
+
+		decomp.state.buffer_index = 0;
+		decomp.state.out0 = decomp.state.out1 = decomp.state.inverts = decomp.state.lps = 0;
+		decomp.state.span = 0xff;
+		decomp.state.val = spc7110dec_dataread();
+		decomp.state.in = spc7110dec_dataread();
+		decomp.state.in_count = 8;
 		return;
 	}
 
@@ -388,51 +519,51 @@ void spc7110dec_mode2(bool init)
 		for (pixel = 0; pixel < 8; pixel++)
 		{
 			/* Get first symbol context */
-			uint32_t a = ((out0 >> (0 * 4)) & 15);
-			uint32_t b = ((out0 >> (7 * 4)) & 15);
-			uint32_t c = ((out1 >> (0 * 4)) & 15);
+			uint32_t a = ((decomp.state.out0 >> (0 * 4)) & 15);
+			uint32_t b = ((decomp.state.out0 >> (7 * 4)) & 15);
+			uint32_t c = ((decomp.state.out1 >> (0 * 4)) & 15);
 			uint32_t con = 0;
 			uint32_t refcon = (a == b) ? (b != c) : (b == c) ? 2 : 4 - (a == c);
 			uint32_t bit, m, n;
 
 			for (m = 0; m < 16; m++) /* Update pixel order */
-				if (pixelorder[m] == a)
+				if (decomp.state.pixelorder[m] == a)
 					break;
 
 			for (n = m; n > 0; n--)
-				pixelorder[n] = pixelorder[n - 1];
+				decomp.state.pixelorder[n] = decomp.state.pixelorder[n - 1];
 
-			pixelorder[0] = a;
+			decomp.state.pixelorder[0] = a;
 
 			for (m = 0; m < 16; m++) /* Calculate the real pixel order */
-				realorder[m] = pixelorder[m];
+				decomp.state.realorder[m] = decomp.state.pixelorder[m];
 
 			for (m = 0; m < 16; m++) /* Rotate reference pixel c value to top */
-				if (realorder[m] == c)
+				if (decomp.state.realorder[m] == c)
 					break;
 
 			for (n = m; n > 0; n--)
-				realorder[n] = realorder[n - 1];
+				decomp.state.realorder[n] = decomp.state.realorder[n - 1];
 
-			realorder[0] = c;
+			decomp.state.realorder[0] = c;
 
 			for (m = 0; m < 16; m++) /* Rotate reference pixel b value to top */
-				if (realorder[m] == b)
+				if (decomp.state.realorder[m] == b)
 					break;
 
 			for (n = m; n > 0; n--)
-				realorder[n] = realorder[n - 1];
+				decomp.state.realorder[n] = decomp.state.realorder[n - 1];
 
-			realorder[0] = b;
+			decomp.state.realorder[0] = b;
 
 			for (m = 0; m < 16; m++) /* Rotate reference pixel a value to top */
-				if (realorder[m] == a)
+				if (decomp.state.realorder[m] == a)
 					break;
 
 			for (n = m; n > 0; n--)
-				realorder[n] = realorder[n - 1];
+				decomp.state.realorder[n] = decomp.state.realorder[n - 1];
 
-			realorder[0] = a;
+			decomp.state.realorder[0] = a;
 
 			for (bit = 0; bit < 4; bit++) /* Get 4 symbols */
 			{
@@ -443,90 +574,90 @@ void spc7110dec_mode2(bool init)
 				uint32_t flag_lps;
 
 				/* Get symbol */
-				if (val <= span - prob) /* mps */
+				if (decomp.state.val <= decomp.state.span - prob) /* mps */
 				{
-					span = span - prob;
+					decomp.state.span = decomp.state.span - prob;
 					flag_lps = 0;
 				}
 				else /* lps */
 				{
-					val = val - (span - (prob - 1));
-					span = prob - 1;
+					decomp.state.val = decomp.state.val - (decomp.state.span - (prob - 1));
+					decomp.state.span = prob - 1;
 					flag_lps = 1;
 				}
 
-				while (span < 0x7f) /* Renormalize */
+				while (decomp.state.span < 0x7f) /* Renormalize */
 				{
 					shift++;
-					span = (span << 1) + 1;
-					val = (val << 1) + (in >> 7);
-					in <<= 1;
+					decomp.state.span = (decomp.state.span << 1) + 1;
+					decomp.state.val = (decomp.state.val << 1) + (decomp.state.in >> 7);
+					decomp.state.in <<= 1;
 
-					if (--in_count == 0)
+					if (--decomp.state.in_count == 0)
 					{
-						in = spc7110dec_dataread();
-						in_count = 8;
+						decomp.state.in = spc7110dec_dataread();
+						decomp.state.in_count = 8;
 					}
 				}
 
 				/* Update processing info */
-				lps = (lps << 1) + flag_lps;
-				invertbit = decomp.context[con].invert;
-				inverts = (inverts << 1) + invertbit;
+				decomp.state.lps = (decomp.state.lps << 1) + flag_lps;
+				invertbit = decomp.state.context[con].invert;
+				decomp.state.inverts = (decomp.state.inverts << 1) + invertbit;
 
-				if (flag_lps & spc7110dec_toggle_invert(con)) /* Update decomp.context state */
-					decomp.context[con].invert ^= 1;
+				if (flag_lps & spc7110dec_toggle_invert(con)) /* Update decomp.state.context state */
+					decomp.state.context[con].invert ^= 1;
 
 				if (flag_lps)
-					decomp.context[con].index = spc7110dec_next_lps(con);
+					decomp.state.context[con].index = spc7110dec_next_lps(con);
 				else if (shift)
-					decomp.context[con].index = spc7110dec_next_mps(con);
+					decomp.state.context[con].index = spc7110dec_next_mps(con);
 
 				/* Get next decomp.context */
 				con = mode2_context_table[con][flag_lps ^ invertbit] + (con == 1 ? refcon : 0);
 			}
 
 			/* Get pixel */
-			b = realorder[(lps ^ inverts) & 0x0f];
-			out1 = (out1 << 4) + ((out0 >> 28) & 0x0f);
-			out0 = (out0 << 4) + b;
+			b = decomp.state.realorder[(decomp.state.lps ^ decomp.state.inverts) & 0x0f];
+			decomp.state.out1 = (decomp.state.out1 << 4) + ((decomp.state.out0 >> 28) & 0x0f);
+			decomp.state.out0 = (decomp.state.out0 << 4) + b;
 		}
 
 		/* Convert pixel data into bitplanes */
-		data = spc7110dec_morton_4x8(out0);
+		data = spc7110dec_morton_4x8(decomp.state.out0);
 		spc7110dec_write(data >> 24);
 		spc7110dec_write(data >> 16);
-		bitplanebuffer[buffer_index++] = data >> 8;
-		bitplanebuffer[buffer_index++] = data >> 0;
+		decomp.state.bitplanebuffer[decomp.state.buffer_index++] = data >> 8;
+		decomp.state.bitplanebuffer[decomp.state.buffer_index++] = data >> 0;
 
-		if (buffer_index != 16)
+		if (decomp.state.buffer_index != 16)
 			continue;
 
 		for (i = 0; i < 16; i++)
-			spc7110dec_write(bitplanebuffer[i]);
+			spc7110dec_write(decomp.state.bitplanebuffer[i]);
 
-		buffer_index = 0;
+		decomp.state.buffer_index = 0;
 	}
 }
 
 uint8_t spc7110dec_probability(uint32_t n)
 {
-	return evolution_table[decomp.context[n].index][0];
+	return evolution_table[decomp.state.context[n].index][0];
 }
 
 uint8_t spc7110dec_next_lps(uint32_t n)
 {
-	return evolution_table[decomp.context[n].index][1];
+	return evolution_table[decomp.state.context[n].index][1];
 }
 
 uint8_t spc7110dec_next_mps(uint32_t n)
 {
-	return evolution_table[decomp.context[n].index][2];
+	return evolution_table[decomp.state.context[n].index][2];
 }
 
 bool spc7110dec_toggle_invert(uint32_t n)
 {
-	return evolution_table[decomp.context[n].index][3];
+	return evolution_table[decomp.state.context[n].index][3];
 }
 
 uint32_t spc7110dec_morton_2x8(uint32_t data)
@@ -547,11 +678,33 @@ uint32_t spc7110dec_morton_4x8(uint32_t data)
 	return decomp.morton32[0][(data >> 0) & 255] + decomp.morton32[1][(data >> 8) & 255] + decomp.morton32[2][(data >> 16) & 255] + decomp.morton32[3][(data >> 24) & 255];
 }
 
+void spc7110dec_flush()
+{
+	SPC7110Packet* p = decomp.packet;
+	uint32_t mode = decomp.mode, offset = p ? p->offset : 0, position = decomp.position;
+	uint32_t i;
+
+	for (i = 0; i < SPC7110_PACKET_ENTRIES; i++)
+		spc7110dec_free(&decomp.packets[i]);
+
+	decomp.packet = NULL;
+	decomp.clock = 0;
+
+	if (p) /* Decompress the packet being read again, up to where the game got */
+	{
+		uint32_t index = decomp.original_index, read_counter = decomp.read_counter;
+		spc7110dec_clear(mode, offset, position, 0);
+		decomp.original_index = index;
+		decomp.read_counter = read_counter;
+	}
+}
+
 void spc7110dec_reset()
 {
 	/* Mode 3 is invalid; this is treated as a special case to always return 0x00
 	 * set to mode 3 so that reading decomp port before starting first decomp will return 0x00 */
 	decomp.mode = 3;
+	decomp.packet = NULL;
 	decomp.buffer_rdoffset = 0;
 	decomp.buffer_wroffset = 0;
 	decomp.buffer_length = 0;
@@ -562,6 +715,7 @@ void spc7110dec_init()
 	uint32_t i;
 	decomp.buffer = (uint8_t*) malloc(SPC7110_DECOMP_BUFFER_SIZE);
 	spc7110dec_reset();
+	spc7110dec_flush();
 
 	for (i = 0; i < 256; i++) /* Initialize reverse morton lookup tables */
 	{
@@ -580,5 +734,7 @@ void spc7110dec_init()
 
 void spc7110dec_deinit()
 {
+	spc7110dec_reset();
+	spc7110dec_flush();
 	free(decomp.buffer);
 }
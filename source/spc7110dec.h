@@ -3,10 +3,78 @@
 
 #include "port.h"
 
+#define SPC7110_PACKET_ENTRIES     32
+#define SPC7110_PACKET_CHUNK       1024               /* Decompressed ahead at a time */
+#define SPC7110_PACKET_MAX_BYTES   0x40000            /* Of one packet, reads past that are decompressed as they come */
+#define SPC7110_PACKET_CACHE_BYTES (2 * 1024 * 1024) /* Decompressed data kept at most */
+
+/* Everything the decoder of the active mode keeps between reads */
+typedef struct
+{
+	uint32_t offset;
+	uint32_t pixelorder[16];
+	uint32_t realorder[16];
+	uint8_t  bitplanebuffer[16];
+	uint8_t  buffer_index;
+	uint8_t  in, val, span;
+	int32_t  out0, out1, inverts, lps, in_count;
+
+	struct
+	{
+		uint8_t index;
+		uint8_t invert;
+	} context[32];
+} SPC7110DecState;
+
+/* The output of one packet from its start, along with the decoder state at the end of it so that it can be
+ * decompressed further when a game reads past it. */
+typedef struct
+{
+	bool            valid;
+	uint32_t        mode;
+	uint32_t        offset;
+	uint32_t        length;
+	uint32_t        size;   /* Of data */
+	uint32_t        last_use;
+	uint8_t*        data;
+	SPC7110DecState state;
+} SPC7110Packet;
+
+typedef struct
+{
+	uint32_t        buffer_length;
+	uint32_t        buffer_rdoffset;
+	uint32_t        buffer_wroffset;
+	uint32_t        mode;
+	uint32_t        original_mode;
+	uint32_t        original_index;
+	uint32_t        original_offset;
+	uint32_t        read_counter;
+	uint32_t        morton16[2][256];
+	uint32_t        morton32[4][256];
+	uint8_t*        buffer;
+	SPC7110DecState state;
+
+	/* Packets decompressed so far, least recently used first out */
+	SPC7110Packet   packets[SPC7110_PACKET_ENTRIES];
+	SPC7110Packet*  packet;   /* Being read, NULL if decompressing into buffer */
+	SPC7110Packet*  decoding; /* The one state is at the end of */
+	uint32_t        position; /* In packet */
+	uint32_t        clock;
+	uint32_t        cache_bytes;
+} SPC7110Decomp;
+
+#ifdef MULTI_INSTANCE
+	#define decomp (*decompPtr)
+#endif
+
+extern INSTANCE SPC7110Decomp decomp;
+
 void     spc7110dec_init();
 void     spc7110dec_deinit();
-void     spc7110dec_clear(uint32_t mode, uint32_t offset, uint32_t index);
+void     spc7110dec_clear(uint32_t mode, uint32_t offset, uint32_t index, uint32_t length);
 void     spc7110dec_reset();
+void     spc7110dec_flush(); /* Must be called whenever the contents of ROM change */
 uint8_t  spc7110dec_read();
 void     spc7110dec_write(uint8_t data);
 uint8_t  spc7110dec_dataread();
@@ -16,7 +16,7 @@ enum
 	RTCM_WRITE   = 3
 };
 
-SSRTCSnap srtcsnap;
+INSTANCE SSRTCSnap srtcsnap;
 static const uint32_t months[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
 static void srtc_update_time()
@@ -12,8 +12,13 @@ typedef struct
 	uint32_t rtc_mode;
 } SSRTCSnap;
 
-extern SRTCData  RTCData;
-extern SSRTCSnap srtcsnap;
+#ifdef MULTI_INSTANCE
+	#define RTCData  (*RTCDataPtr)
+	#define srtcsnap (*srtcsnapPtr)
+#endif
+
+extern INSTANCE SRTCData  RTCData;
+extern INSTANCE SSRTCSnap srtcsnap;
 
 void    InitSRTC();
 void    ResetSRTC();
@@ -289,12 +289,135 @@
 			break;                                                                \
 	}
 
+/* Converting a tile gives every pixel a byte made of one bit from each bitplane. For a single line the plane bytes can be
+ * seen as the rows of an 8x8 matrix of bits and the pixel bytes as its columns, so the conversion is a quarter turn of
+ * that matrix. Packed into a 64 bit word with the last plane first, that takes three rounds of swapping blocks of bits,
+ * without any lookups or branches. SSE2 turns two lines at once. The lookup tables are kept for big endian hosts and
+ * for 32 bit hosts without SSE2, where the 64 bit shifts would have to be split. */
+#if defined(GFX_SSE2)
+	#define CONVERT_TILE_SSE2
+#elif !defined(MSB_FIRST) && UINTPTR_MAX > 0xffffffffU
+	#define CONVERT_TILE_SWAR
+#endif
+
+#if defined(CONVERT_TILE_SSE2)
+static INLINE __m128i TurnTileLines(__m128i x)
+{
+	const __m128i k1 = _mm_set1_epi64x(0xaa00aa00aa00aa00LL);
+	const __m128i k2 = _mm_set1_epi64x(0xcccc0000cccc0000LL);
+	const __m128i k4 = _mm_set1_epi64x(0xf0f0f0f00f0f0f0fLL);
+	__m128i t;
+	t = _mm_xor_si128(x, _mm_slli_epi64(x, 36));
+	x = _mm_xor_si128(x, _mm_and_si128(k4, _mm_xor_si128(t, _mm_srli_epi64(x, 36))));
+	t = _mm_and_si128(k2, _mm_xor_si128(x, _mm_slli_epi64(x, 18)));
+	x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_srli_epi64(t, 18)));
+	t = _mm_and_si128(k1, _mm_xor_si128(x, _mm_slli_epi64(x, 9)));
+	return _mm_xor_si128(x, _mm_xor_si128(t, _mm_srli_epi64(t, 9)));
+}
+
+/* Every 16 bytes of a tile hold two bitplanes, interleaved line by line */
+static INLINE __m128i LoadTilePlanes(const uint8_t* tp)
+{
+	__m128i x = _mm_loadu_si128((const __m128i*) tp);
+	return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+static INLINE uint8_t ConvertTileSSE2(uint8_t* pCache, uint32_t TileAddr, uint8_t planes)
+{
+	const uint8_t* tp = GFX.VRAM + TileAddr;
+	__m128i        zero = _mm_setzero_si128();
+	__m128i        p01, p23, p45, p67, lo, hi, l01, l23, l45, l67;
+	PERF_COUNT(PERF_CONVERTED_TILES, 1);
+	p01 = LoadTilePlanes(tp);
+	p23 = planes > 2 ? LoadTilePlanes(tp + 16) : zero;
+	p45 = planes > 4 ? LoadTilePlanes(tp + 32) : zero;
+	p67 = planes > 4 ? LoadTilePlanes(tp + 48) : zero;
+	lo  = _mm_unpacklo_epi16(p67, p45);
+	hi  = _mm_unpacklo_epi16(p23, p01);
+	l01 = TurnTileLines(_mm_unpacklo_epi32(lo, hi));
+	l23 = TurnTileLines(_mm_unpackhi_epi32(lo, hi));
+	lo  = _mm_unpackhi_epi16(p67, p45);
+	hi  = _mm_unpackhi_epi16(p23, p01);
+	l45 = TurnTileLines(_mm_unpacklo_epi32(lo, hi));
+	l67 = TurnTileLines(_mm_unpackhi_epi32(lo, hi));
+	_mm_storeu_si128((__m128i*) pCache, l01);
+	_mm_storeu_si128((__m128i*) (pCache + 16), l23);
+	_mm_storeu_si128((__m128i*) (pCache + 32), l45);
+	_mm_storeu_si128((__m128i*) (pCache + 48), l67);
+	lo = _mm_or_si128(_mm_or_si128(l01, l23), _mm_or_si128(l45, l67));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(lo, zero)) != 0xffff ? 1 : BLANK_TILE;
+}
+
+static uint8_t ConvertTile8bpp(uint8_t* pCache, uint32_t TileAddr)
+{
+	return ConvertTileSSE2(pCache, TileAddr, 8);
+}
+
+static uint8_t ConvertTile4bpp(uint8_t* pCache, uint32_t TileAddr)
+{
+	return ConvertTileSSE2(pCache, TileAddr, 4);
+}
+
+static uint8_t ConvertTile2bpp(uint8_t* pCache, uint32_t TileAddr)
+{
+	return ConvertTileSSE2(pCache, TileAddr, 2);
+}
+#elif defined(CONVERT_TILE_SWAR)
+static INLINE uint64_t TurnTileLine(uint64_t x)
+{
+	uint64_t t;
+	t  = x ^ (x << 36);
+	x ^= 0xf0f0f0f00f0f0f0fULL & (t ^ (x >> 36));
+	t  = 0xcccc0000cccc0000ULL & (x ^ (x << 18));
+	x ^= t ^ (t >> 18);
+	t  = 0xaa00aa00aa00aa00ULL & (x ^ (x << 9));
+	return x ^ t ^ (t >> 9);
+}
+
+static INLINE uint8_t ConvertTileSWAR(uint8_t* pCache, uint32_t TileAddr, uint8_t planes)
+{
+	const uint8_t* tp       = GFX.VRAM + TileAddr;
+	uint64_t       non_zero = 0;
+	uint8_t        line, plane;
+	PERF_COUNT(PERF_CONVERTED_TILES, 1);
+
+	for (line = 0; line < 8; line++, tp += 2, pCache += 8)
+	{
+		uint64_t x = 0;
+
+		for (plane = 0; plane < planes; plane++)
+			x |= (uint64_t) tp[((plane >> 1) << 4) + (plane & 1)] << ((7 - plane) << 3);
+
+		x = TurnTileLine(x);
+		memcpy(pCache, &x, sizeof(x));
+		non_zero |= x;
+	}
+
+	return non_zero ? 1 : BLANK_TILE;
+}
+
 static uint8_t ConvertTile8bpp(uint8_t* pCache, uint32_t TileAddr)
 {
-	uint8_t*  tp = Memory.VRAM + TileAddr;
+	return ConvertTileSWAR(pCache, TileAddr, 8);
+}
+
+static uint8_t ConvertTile4bpp(uint8_t* pCache, uint32_t TileAddr)
+{
+	return ConvertTileSWAR(pCache, TileAddr, 4);
+}
+
+static uint8_t ConvertTile2bpp(uint8_t* pCache, uint32_t TileAddr)
+{
+	return ConvertTileSWAR(pCache, TileAddr, 2);
+}
+#else
+static uint8_t ConvertTile8bpp(uint8_t* pCache, uint32_t TileAddr)
+{
+	uint8_t*  tp = GFX.VRAM + TileAddr;
 	uint32_t* p  = (uint32_t*) pCache;
 	uint8_t   line, pix;
 	uint32_t  p1, p2, non_zero = 0;
+	PERF_COUNT(PERF_CONVERTED_TILES, 1);
 
 	for (line = 8; line != 0; line--, tp += 2)
 	{
@@ -358,10 +481,11 @@ static uint8_t ConvertTile8bpp(uint8_t* pCache, uint32_t TileAddr)
 
 static uint8_t ConvertTile4bpp(uint8_t* pCache, uint32_t TileAddr)
 {
-	uint8_t*  tp = Memory.VRAM + TileAddr;
+	uint8_t*  tp = GFX.VRAM + TileAddr;
 	uint32_t* p  = (uint32_t*) pCache;
 	uint8_t   line, pix;
 	uint32_t  p1, p2, non_zero = 0;
+	PERF_COUNT(PERF_CONVERTED_TILES, 1);
 
 	for (line = 8; line != 0; line--, tp += 2)
 	{
@@ -401,10 +525,11 @@ static uint8_t ConvertTile4bpp(uint8_t* pCache, uint32_t TileAddr)
 
 static uint8_t ConvertTile2bpp(uint8_t* pCache, uint32_t TileAddr)
 {
-	uint8_t*  tp = Memory.VRAM + TileAddr;
+	uint8_t*  tp = GFX.VRAM + TileAddr;
 	uint32_t* p  = (uint32_t*) pCache;
 	uint8_t   line, pix;
 	uint32_t  p1, p2, non_zero = 0;
+	PERF_COUNT(PERF_CONVERTED_TILES, 1);
 
 	for (line = 8; line != 0; line--, tp += 2)
 	{
@@ -429,6 +554,7 @@ static uint8_t ConvertTile2bpp(uint8_t* pCache, uint32_t TileAddr)
 
 	return non_zero ? 1 : BLANK_TILE;
 }
+#endif
 
 void SelectConvertTile()
 {
@@ -676,6 +802,176 @@ void DrawLargePixel16HalfWidth(uint32_t Tile, int32_t Offset, uint32_t StartPixe
 	RENDER_TILE_LARGE_HALFWIDTH(ScreenColors[pixel], PLOT_PIXEL);
 }
 
+/* With SSE2 the colour math is done for a whole line of a tile at once, each pixel in a 16 bit lane. The lanes that fail
+ * the depth test or are transparent keep what was on the screen. */
+#ifdef COLOUR_MATH_SSE2
+/* Draws the 8 pixels of a tile line, in screen order unless Flip is set */
+static ALWAYS_INLINE void WRITE_8PIXELS16_MATH(uint16_t* Screen, uint8_t* Depth, const uint8_t* SubDepth, const uint16_t* SubScreen, const uint8_t* Pixels, bool Flip, const uint16_t* ScreenColors, uint8_t Op)
+{
+	__m128i zero  = _mm_setzero_si128();
+	__m128i pix   = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) Pixels), zero);
+	__m128i depth = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) Depth), zero);
+	__m128i sub   = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) SubDepth), zero);
+	__m128i draw, colours, result;
+
+	if (Flip)
+	{
+		pix     = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(pix, 0x1B), 0x1B), 0x4E);
+		colours = _mm_setr_epi16(ScreenColors[Pixels[7]], ScreenColors[Pixels[6]], ScreenColors[Pixels[5]], ScreenColors[Pixels[4]], ScreenColors[Pixels[3]], ScreenColors[Pixels[2]], ScreenColors[Pixels[1]], ScreenColors[Pixels[0]]);
+	}
+	else
+	{
+		colours = _mm_setr_epi16(ScreenColors[Pixels[0]], ScreenColors[Pixels[1]], ScreenColors[Pixels[2]], ScreenColors[Pixels[3]], ScreenColors[Pixels[4]], ScreenColors[Pixels[5]], ScreenColors[Pixels[6]], ScreenColors[Pixels[7]]);
+	}
+
+	draw = _mm_andnot_si128(_mm_cmpeq_epi16(pix, zero), _mm_cmpgt_epi16(_mm_set1_epi16(GFX.Z1), depth));
+
+	if (!_mm_movemask_epi8(draw))
+		return;
+
+	result = ColourMathSSE2(colours, sub, SubScreen, Op);
+	_mm_storeu_si128((__m128i*) Screen, SelectSSE2(draw, result, _mm_loadu_si128((const __m128i*) Screen)));
+	depth = SelectSSE2(draw, _mm_set1_epi16(GFX.Z2), depth);
+	_mm_storel_epi64((__m128i*) Depth, _mm_packus_epi16(depth, depth));
+}
+
+static ALWAYS_INLINE void DrawTile16Math(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount, uint8_t Op)
+{
+	uint8_t* bp;
+	int32_t  Step;
+	TILE_PREAMBLE_VARS();
+	TILE_PREAMBLE_CODE();
+
+	if (Tile & V_FLIP)
+	{
+		bp   = pCache + 56 - StartLine;
+		Step = -8;
+	}
+	else
+	{
+		bp   = pCache + StartLine;
+		Step = 8;
+	}
+
+	if (Tile & H_FLIP)
+	{
+		for (l = LineCount; l != 0; l--, bp += Step, Offset += GFX.PPL)
+			WRITE_8PIXELS16_MATH((uint16_t*) GFX.S + Offset, GFX.ZBuffer + Offset, GFX.SubZBuffer + Offset, (uint16_t*) GFX.S + Offset + GFX.Delta, bp, true, ScreenColors, Op);
+	}
+	else
+	{
+		for (l = LineCount; l != 0; l--, bp += Step, Offset += GFX.PPL)
+			WRITE_8PIXELS16_MATH((uint16_t*) GFX.S + Offset, GFX.ZBuffer + Offset, GFX.SubZBuffer + Offset, (uint16_t*) GFX.S + Offset + GFX.Delta, bp, false, ScreenColors, Op);
+	}
+}
+
+/* The pixels of a clipped tile that lie outside the clip may also be outside the screen, so the visible ones are copied
+ * to a line of their own, with the others made transparent, and back again. */
+static ALWAYS_INLINE void DrawClippedTile16Math(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount, uint8_t Op)
+{
+	uint8_t* bp;
+	int32_t  Step;
+	uint16_t LineScreen[8], LineSubScreen[8];
+	uint8_t  LineDepth[8], LineSubDepth[8], LinePixels[8];
+	TILE_PREAMBLE_VARS();
+	TILE_PREAMBLE_CODE();
+
+	if (Tile & V_FLIP)
+	{
+		bp   = pCache + 56 - StartLine;
+		Step = -8;
+	}
+	else
+	{
+		bp   = pCache + StartLine;
+		Step = 8;
+	}
+
+	memset(LineScreen, 0, sizeof(LineScreen));
+	memset(LineSubScreen, 0, sizeof(LineSubScreen));
+	memset(LineDepth, 0, sizeof(LineDepth));
+	memset(LineSubDepth, 0, sizeof(LineSubDepth));
+	memset(LinePixels, 0, sizeof(LinePixels));
+	Offset += StartPixel;
+
+	for (l = LineCount; l != 0; l--, bp += Step, Offset += GFX.PPL)
+	{
+		uint16_t* Screen = (uint16_t*) GFX.S + Offset;
+		uint32_t  N;
+
+		for (N = 0; N < Width; N++)
+			LinePixels[StartPixel + N] = bp[(Tile & H_FLIP) ? 7 - StartPixel - N : StartPixel + N];
+
+		memcpy(LineScreen + StartPixel, Screen, Width * sizeof(uint16_t));
+		memcpy(LineSubScreen + StartPixel, Screen + GFX.Delta, Width * sizeof(uint16_t));
+		memcpy(LineDepth + StartPixel, GFX.ZBuffer + Offset, Width);
+		memcpy(LineSubDepth + StartPixel, GFX.SubZBuffer + Offset, Width);
+		WRITE_8PIXELS16_MATH(LineScreen, LineDepth, LineSubDepth, LineSubScreen, LinePixels, false, ScreenColors, Op);
+		memcpy(Screen, LineScreen + StartPixel, Width * sizeof(uint16_t));
+		memcpy(GFX.ZBuffer + Offset, LineDepth + StartPixel, Width);
+	}
+}
+
+void DrawTile16Add(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawTile16Math(Tile, Offset, StartLine, LineCount, MATH_ADD);
+}
+
+void DrawClippedTile16Add(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawClippedTile16Math(Tile, Offset, StartPixel, Width, StartLine, LineCount, MATH_ADD);
+}
+
+void DrawTile16Add1_2(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawTile16Math(Tile, Offset, StartLine, LineCount, MATH_ADD1_2);
+}
+
+void DrawClippedTile16Add1_2(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawClippedTile16Math(Tile, Offset, StartPixel, Width, StartLine, LineCount, MATH_ADD1_2);
+}
+
+void DrawTile16Sub(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawTile16Math(Tile, Offset, StartLine, LineCount, MATH_SUB);
+}
+
+void DrawClippedTile16Sub(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawClippedTile16Math(Tile, Offset, StartPixel, Width, StartLine, LineCount, MATH_SUB);
+}
+
+void DrawTile16Sub1_2(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawTile16Math(Tile, Offset, StartLine, LineCount, MATH_SUB1_2);
+}
+
+void DrawClippedTile16Sub1_2(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawClippedTile16Math(Tile, Offset, StartPixel, Width, StartLine, LineCount, MATH_SUB1_2);
+}
+
+void DrawTile16FixedAdd1_2(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawTile16Math(Tile, Offset, StartLine, LineCount, MATH_FIXED_ADD1_2);
+}
+
+void DrawClippedTile16FixedAdd1_2(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawClippedTile16Math(Tile, Offset, StartPixel, Width, StartLine, LineCount, MATH_FIXED_ADD1_2);
+}
+
+void DrawTile16FixedSub1_2(uint32_t Tile, int32_t Offset, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawTile16Math(Tile, Offset, StartLine, LineCount, MATH_FIXED_SUB1_2);
+}
+
+void DrawClippedTile16FixedSub1_2(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Width, uint32_t StartLine, uint32_t LineCount)
+{
+	DrawClippedTile16Math(Tile, Offset, StartPixel, Width, StartLine, LineCount, MATH_FIXED_SUB1_2);
+}
+#else
 static void WRITE_4PIXELS16_ADD(int32_t Offset, uint8_t* Pixels, uint16_t* ScreenColors)
 {
 	uint8_t   Pixel, N;
@@ -1230,6 +1526,7 @@ void DrawClippedTile16FixedSub1_2(uint32_t Tile, int32_t Offset, uint32_t StartP
 	TILE_CLIP_PREAMBLE_CODE();
 	RENDER_CLIPPED_TILE_CODE(WRITE_4PIXELS16_SUBF1_2, WRITE_4PIXELS16_FLIPPED_SUBF1_2, 4);
 }
+#endif
 
 void DrawLargePixel16Add(uint32_t Tile, int32_t Offset, uint32_t StartPixel, uint32_t Pixels, uint32_t StartLine, uint32_t LineCount)
 {
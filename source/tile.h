@@ -1,6 +1,11 @@
 #ifndef CHIMERASNES_TILE_H_
 #define CHIMERASNES_TILE_H_
-extern uint8_t (*ConvertTile)(uint8_t*, uint32_t);
+
+#ifdef MULTI_INSTANCE
+	#define ConvertTile (*ConvertTilePtr)
+#endif
+
+extern INSTANCE uint8_t (*ConvertTile)(uint8_t*, uint32_t);
 
 void SelectConvertTile();
 #endif